@@ -0,0 +1,110 @@
+#include "block_file.h"
+#include "statistics.h"
+#include "stencil_proxy.h"
+#include "structured_part.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using namespace structured_part;
+
+namespace {
+
+void printUsage(std::ostream& os, const char* exe_name)
+{
+  os << "Usage: " << exe_name << " block_file nprocs [load_balance_factor] [-n num_iterations] [-e engine]\n"
+     << "\n"
+     << "  block_file: text file with one line per mesh block: block_id nx ny nz [weight]\n"
+     << "  nprocs: number of processes to partition the mesh for.  Each process is\n"
+     << "          simulated by a thread\n"
+     << "  load_balance_factor: maximum allowed imbalance, default 0.1\n"
+     << "  num_iterations: number of stencil iterations to time, default 100\n"
+     << "  engine: partitioning engine, split (the default), rcb or all.  With all,\n"
+     << "          each engine is run and timed in turn for comparison\n";
+}
+
+std::vector<PartitionEngine> parseEngines(const std::string& name)
+{
+  if (name == "split")
+    return {PartitionEngine::SplitAndAssign};
+  else if (name == "rcb")
+    return {PartitionEngine::RecursiveBisection};
+  else if (name == "all")
+    return {PartitionEngine::SplitAndAssign, PartitionEngine::RecursiveBisection};
+  else
+    throw std::runtime_error("unknown engine " + name);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  std::vector<std::string> positional_args;
+  UInt num_iterations = 100;
+  std::string engine_name = "split";
+  for (int i=1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      num_iterations = std::stoul(argv[++i]);
+    else if (std::strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+      engine_name = argv[++i];
+    else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0)
+    {
+      printUsage(std::cout, argv[0]);
+      return 0;
+    } else
+      positional_args.push_back(argv[i]);
+  }
+
+  if (positional_args.size() < 2 || positional_args.size() > 3)
+  {
+    printUsage(std::cerr, argv[0]);
+    return 1;
+  }
+
+  try
+  {
+    UInt nprocs = std::stoul(positional_args[1]);
+    double load_balance_factor = positional_args.size() > 2 ? std::stod(positional_args[2]) : 0.1;
+    if (nprocs == 0)
+      throw std::runtime_error("nprocs must be greater than zero");
+
+    std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = readBlockFile(positional_args[0]);
+    for (PartitionEngine engine : parseEngines(engine_name))
+    {
+      PartitionOptions options;
+      options.engine = engine;
+      auto start = std::chrono::steady_clock::now();
+      PartitionResult result = partitionMesh(mesh_blocks, nprocs, load_balance_factor, options);
+      std::chrono::duration<double> partition_time = std::chrono::steady_clock::now() - start;
+      const std::vector<std::vector<SplitBlock>>& blocks_on_procs = result.blocks_on_procs;
+
+      std::cout << "engine: " << getName(engine) << ", status: " << getName(result.status) << std::endl;
+      std::cout << "partition time (s) = " << partition_time.count() << std::endl;
+      std::cout << computeDecompStats(blocks_on_procs) << std::endl;
+
+      StencilProxy proxy(blocks_on_procs);
+      ProxyTimings timings = proxy.run(num_iterations);
+      std::cout << timings << std::endl;
+
+      std::cout << "rank, compute time (s), exchange time (s), weight" << std::endl;
+      for (UInt proc=0; proc < nprocs; ++proc)
+      {
+        double weight = 0.0;
+        for (const SplitBlock& block : blocks_on_procs[proc])
+          weight += block.weight;
+
+        std::cout << proc << ", " << timings.compute_time_per_rank[proc] << ", "
+                  << timings.exchange_time_per_rank[proc] << ", " << weight << std::endl;
+      }
+      std::cout << std::endl;
+    }
+  } catch (std::exception& e)
+  {
+    std::cerr << "error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,308 @@
+#include "stencil_proxy.h"
+#include "adjacency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+
+namespace structured_part {
+
+namespace {
+
+constexpr double BoundaryValue = 1.0;
+
+}
+
+struct StencilProxy::BlockData
+{
+  explicit BlockData(const SplitBlock& block) :
+    block(block),
+    dims{block.element_counts[0] + 2, block.element_counts[1] + 2, block.element_counts[2] + 2},
+    u(prod(dims), BoundaryValue),
+    u_new(prod(dims), BoundaryValue)
+  {
+    // the interior starts at zero, the ghosts that are not overwritten by halo
+    // exchange keep the boundary value
+    for (UInt i=1; i < dims[0] - 1; ++i)
+      for (UInt j=1; j < dims[1] - 1; ++j)
+        for (UInt k=1; k < dims[2] - 1; ++k)
+          u[getIdx(i, j, k)] = 0.0;
+  }
+
+  // indices include the ghost layer, so the interior is [1, element_counts[d]]
+  UInt getIdx(UInt i, UInt j, UInt k) const { return (i * dims[1] + j) * dims[2] + k; }
+
+  SplitBlock block;
+  std::array<UInt, 3> dims;
+  std::vector<double> u;
+  std::vector<double> u_new;
+};
+
+// the face of src_block that is sent to the ghost layer of dst_block.  The ranges are in
+// MeshBlock coordinates, with range[dir] being the single layer of src_block that is sent
+struct StencilProxy::Message
+{
+  UInt src_block;
+  UInt dst_block;
+  UInt dir;
+  UInt dst_layer;  // index of the ghost layer of dst_block in direction dir (0 or element_counts[dir] + 1)
+  std::array<UInt, 3> start;
+  std::array<UInt, 3> end;
+  std::vector<double> buffer;
+};
+
+class StencilProxy::Barrier
+{
+  public:
+    explicit Barrier(UInt num_threads) :
+      m_num_threads(num_threads)
+    {}
+
+    void wait()
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      UInt generation = m_generation;
+      if (++m_num_waiting == m_num_threads)
+      {
+        m_num_waiting = 0;
+        m_generation++;
+        m_cv.notify_all();
+      } else
+        m_cv.wait(lock, [&] { return generation != m_generation; });
+    }
+
+  private:
+    UInt m_num_threads;
+    UInt m_num_waiting = 0;
+    UInt m_generation = 0;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+StencilProxy::StencilProxy(const std::vector<std::vector<SplitBlock>>& blocks_on_procs) :
+  m_block_idxs_on_procs(blocks_on_procs.size()),
+  m_send_msgs_on_procs(blocks_on_procs.size()),
+  m_recv_msgs_on_procs(blocks_on_procs.size())
+{
+  for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
+    for (const SplitBlock& block : blocks_on_procs[proc])
+    {
+      m_block_idxs_on_procs[proc].push_back(m_blocks.size());
+      m_blocks.emplace_back(block);
+    }
+
+  setupMessages();
+
+  std::vector<UInt> block_procs(m_blocks.size());
+  for (UInt proc=0; proc < m_block_idxs_on_procs.size(); ++proc)
+    for (UInt idx : m_block_idxs_on_procs[proc])
+      block_procs[idx] = proc;
+
+  for (UInt i=0; i < m_messages.size(); ++i)
+  {
+    m_send_msgs_on_procs[block_procs[m_messages[i].src_block]].push_back(i);
+    m_recv_msgs_on_procs[block_procs[m_messages[i].dst_block]].push_back(i);
+  }
+}
+
+StencilProxy::~StencilProxy() = default;
+
+void StencilProxy::setupMessages()
+{
+  std::vector<SplitBlock> blocks;
+  for (const BlockData& block_data : m_blocks)
+    blocks.push_back(block_data.block);
+
+  for (const BlockAdjacency& adjacency : computeBlockAdjacency(blocks))
+  {
+    for (auto [lower, upper] : {std::make_pair(adjacency.block1, adjacency.block2), std::make_pair(adjacency.block2, adjacency.block1)})
+    {
+      // only one of the orderings has lower_block below upper_block
+      const SplitBlock& lower_block = blocks[lower];
+      const SplitBlock& upper_block = blocks[upper];
+
+      for (UInt dir=0; dir < 3; ++dir)
+      {
+        if (lower_block.mesh_offsets[dir] + lower_block.element_counts[dir] != upper_block.mesh_offsets[dir])
+          continue;
+
+        std::array<UInt, 3> start, end;
+        for (UInt d=0; d < 3; ++d)
+        {
+          start[d] = std::max(lower_block.mesh_offsets[d], upper_block.mesh_offsets[d]);
+          end[d]   = std::min(lower_block.mesh_offsets[d] + lower_block.element_counts[d],
+                              upper_block.mesh_offsets[d] + upper_block.element_counts[d]);
+        }
+
+        // top layer of lower_block to the bottom ghost layer of upper_block.  The reverse
+        // message is created when lower and upper are swapped
+        Message msg{lower, upper, dir, 0, start, end, {}};
+        msg.start[dir] = upper_block.mesh_offsets[dir] - 1;
+        msg.end[dir]   = upper_block.mesh_offsets[dir];
+        msg.buffer.resize((msg.end[0] - msg.start[0]) * (msg.end[1] - msg.start[1]) * (msg.end[2] - msg.start[2]));
+        m_messages.push_back(std::move(msg));
+
+        // bottom layer of upper_block to the top ghost layer of lower_block
+        msg = Message{upper, lower, dir, lower_block.element_counts[dir] + 1, start, end, {}};
+        msg.start[dir] = upper_block.mesh_offsets[dir];
+        msg.end[dir]   = upper_block.mesh_offsets[dir] + 1;
+        msg.buffer.resize((msg.end[0] - msg.start[0]) * (msg.end[1] - msg.start[1]) * (msg.end[2] - msg.start[2]));
+        m_messages.push_back(std::move(msg));
+      }
+    }
+  }
+}
+
+void StencilProxy::pack(Message& msg) const
+{
+  const BlockData& src = m_blocks[msg.src_block];
+  const std::array<UInt, 3>& offsets = src.block.mesh_offsets;
+  UInt idx = 0;
+  for (UInt i=msg.start[0]; i < msg.end[0]; ++i)
+    for (UInt j=msg.start[1]; j < msg.end[1]; ++j)
+      for (UInt k=msg.start[2]; k < msg.end[2]; ++k)
+        msg.buffer[idx++] = src.u[src.getIdx(i - offsets[0] + 1, j - offsets[1] + 1, k - offsets[2] + 1)];
+}
+
+void StencilProxy::unpack(const Message& msg)
+{
+  BlockData& dst = m_blocks[msg.dst_block];
+  const std::array<UInt, 3>& offsets = dst.block.mesh_offsets;
+  std::array<UInt, 3> start = msg.start, end = msg.end;
+  start[msg.dir] = offsets[msg.dir] + msg.dst_layer - 1;
+  end[msg.dir]   = start[msg.dir] + 1;
+
+  // the ghost layer below the block has MeshBlock coordinate offset - 1, so do the
+  // arithmetic with the + 1 first to avoid unsigned underflow
+  UInt idx = 0;
+  for (UInt i=start[0]; i < end[0]; ++i)
+    for (UInt j=start[1]; j < end[1]; ++j)
+      for (UInt k=start[2]; k < end[2]; ++k)
+        dst.u[dst.getIdx(i + 1 - offsets[0], j + 1 - offsets[1], k + 1 - offsets[2])] = msg.buffer[idx++];
+}
+
+void StencilProxy::computeStencil(BlockData& block)
+{
+  const std::array<UInt, 3>& dims = block.dims;
+  const UInt stride_i = dims[1] * dims[2];
+  const UInt stride_j = dims[2];
+  const double* u = block.u.data();
+  double* u_new = block.u_new.data();
+  for (UInt i=1; i < dims[0] - 1; ++i)
+    for (UInt j=1; j < dims[1] - 1; ++j)
+      for (UInt k=1; k < dims[2] - 1; ++k)
+      {
+        UInt idx = i * stride_i + j * stride_j + k;
+        u_new[idx] = (u[idx] + u[idx - stride_i] + u[idx + stride_i] + u[idx - stride_j] + u[idx + stride_j] +
+                      u[idx - 1] + u[idx + 1]) / 7.0;
+      }
+
+  std::swap(block.u, block.u_new);
+}
+
+double StencilProxy::computeChecksum() const
+{
+  double checksum = 0.0;
+  for (const BlockData& block : m_blocks)
+    for (UInt i=1; i < block.dims[0] - 1; ++i)
+      for (UInt j=1; j < block.dims[1] - 1; ++j)
+        for (UInt k=1; k < block.dims[2] - 1; ++k)
+          checksum += block.u[block.getIdx(i, j, k)];
+
+  return checksum;
+}
+
+ProxyTimings StencilProxy::run(UInt num_iterations)
+{
+  if (num_iterations == 0)
+    throw std::runtime_error("number of iterations must be greater than zero");
+
+  using Clock = std::chrono::steady_clock;
+  UInt nprocs = m_block_idxs_on_procs.size();
+  Barrier barrier(nprocs);
+
+  ProxyTimings timings;
+  timings.compute_time_per_rank.resize(nprocs, 0.0);
+  timings.exchange_time_per_rank.resize(nprocs, 0.0);
+  Clock::time_point start_time;
+
+  auto rankMain = [&](UInt proc)
+  {
+    double compute_time = 0.0, exchange_time = 0.0;
+    for (UInt iter=0; iter <= num_iterations; ++iter)
+    {
+      // iteration 0 is a warm-up
+      if (iter == 1)
+      {
+        compute_time = exchange_time = 0.0;
+        barrier.wait();
+        if (proc == 0)
+          start_time = Clock::now();
+      }
+
+      auto t0 = Clock::now();
+      for (UInt msg_idx : m_send_msgs_on_procs[proc])
+        pack(m_messages[msg_idx]);
+      exchange_time += std::chrono::duration<double>(Clock::now() - t0).count();
+
+      barrier.wait();
+
+      t0 = Clock::now();
+      for (UInt msg_idx : m_recv_msgs_on_procs[proc])
+        unpack(m_messages[msg_idx]);
+      auto t1 = Clock::now();
+      for (UInt block_idx : m_block_idxs_on_procs[proc])
+        computeStencil(m_blocks[block_idx]);
+      auto t2 = Clock::now();
+      exchange_time += std::chrono::duration<double>(t1 - t0).count();
+      compute_time  += std::chrono::duration<double>(t2 - t1).count();
+
+      // the buffers cannot be overwritten until all procs have unpacked them
+      barrier.wait();
+    }
+
+    timings.compute_time_per_rank[proc]  = compute_time / num_iterations;
+    timings.exchange_time_per_rank[proc] = exchange_time / num_iterations;
+  };
+
+  std::vector<std::thread> threads;
+  for (UInt proc=1; proc < nprocs; ++proc)
+    threads.emplace_back(rankMain, proc);
+  rankMain(0);
+
+  for (std::thread& thread : threads)
+    thread.join();
+
+  timings.time_per_iteration = std::chrono::duration<double>(Clock::now() - start_time).count() / num_iterations;
+  timings.checksum = computeChecksum();
+
+  return timings;
+}
+
+std::ostream& operator<<(std::ostream& os, const ProxyTimings& timings)
+{
+  UInt nprocs = timings.compute_time_per_rank.size();
+  double max_compute = 0.0, avg_compute = 0.0, max_exchange = 0.0;
+  for (UInt proc=0; proc < nprocs; ++proc)
+  {
+    max_compute = std::max(max_compute, timings.compute_time_per_rank[proc]);
+    avg_compute += timings.compute_time_per_rank[proc] / nprocs;
+    max_exchange = std::max(max_exchange, timings.exchange_time_per_rank[proc]);
+  }
+
+  os << "time per iteration (s) = " << timings.time_per_iteration << std::endl;
+  os << "max, avg compute time per rank (s) = " << max_compute << ", " << avg_compute << std::endl;
+  os << "max exchange time per rank (s) = " << max_exchange << std::endl;
+  os << "measured compute imbalance % = " << 100 * (max_compute - avg_compute) / avg_compute << std::endl;
+  std::streamsize precision = os.precision(15);
+  os << "checksum = " << timings.checksum;
+  os.precision(precision);
+
+  return os;
+}
+
+}
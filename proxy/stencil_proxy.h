@@ -0,0 +1,60 @@
+#ifndef STRUCTURED_PART_STENCIL_PROXY_H
+#define STRUCTURED_PART_STENCIL_PROXY_H
+
+#include "blocks.h"
+#include <vector>
+
+namespace structured_part {
+
+struct ProxyTimings
+{
+  double time_per_iteration = 0.0;           // wall time
+  std::vector<double> compute_time_per_rank; // time spent in the stencil, per iteration
+  std::vector<double> exchange_time_per_rank; // time spent packing and unpacking halos, per iteration
+  double checksum = 0.0;                     // sum of the solution.  Only depends on the decomposition
+                                             // through the floating point summation order
+};
+
+std::ostream& operator<<(std::ostream& os, const ProxyTimings& timings);
+
+// Proxy app for measuring the runtime of a decomposition.  Each rank is simulated by a
+// thread that runs a 7-point Jacobi stencil on each of its SplitBlocks and exchanges
+// halos with the face-adjacent SplitBlocks (on any rank) through shared memory buffers.
+// The boundaries of the MeshBlocks are treated as physical boundaries with a fixed value,
+// because there is no connectivity information between MeshBlocks
+class StencilProxy
+{
+  public:
+    explicit StencilProxy(const std::vector<std::vector<SplitBlock>>& blocks_on_procs);
+
+    ~StencilProxy();
+
+    // runs num_iterations iterations (after one untimed warm-up iteration).  Throws if
+    // num_iterations is zero
+    ProxyTimings run(UInt num_iterations);
+
+  private:
+    struct BlockData;
+    struct Message;
+    class Barrier;
+
+    void setupMessages();
+
+    void pack(Message& msg) const;
+
+    void unpack(const Message& msg);
+
+    void computeStencil(BlockData& block);
+
+    double computeChecksum() const;
+
+    std::vector<std::vector<UInt>> m_block_idxs_on_procs;
+    std::vector<BlockData> m_blocks;
+    std::vector<Message> m_messages;
+    std::vector<std::vector<UInt>> m_send_msgs_on_procs;
+    std::vector<std::vector<UInt>> m_recv_msgs_on_procs;
+};
+
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include "adjacency.h"
+#include <algorithm>
+#include <functional>
+
+namespace structured_part {
+
+UInt computeSharedFaceArea(const SplitBlock& lhs, const SplitBlock& rhs)
+{
+  if (lhs.meshblock != rhs.meshblock)
+    return 0;
+
+  UInt touching_dir = 3;
+  UInt area = 1;
+  for (UInt d=0; d < 3; ++d)
+  {
+    UInt lhs_lo = lhs.mesh_offsets[d], lhs_hi = lhs.mesh_offsets[d] + lhs.element_counts[d];
+    UInt rhs_lo = rhs.mesh_offsets[d], rhs_hi = rhs.mesh_offsets[d] + rhs.element_counts[d];
+
+    if (lhs_hi == rhs_lo || rhs_hi == lhs_lo)
+    {
+      // blocks can only touch in one direction and overlap in the others
+      if (touching_dir != 3)
+        return 0;
+
+      touching_dir = d;
+    } else
+    {
+      UInt overlap_lo = std::max(lhs_lo, rhs_lo);
+      UInt overlap_hi = std::min(lhs_hi, rhs_hi);
+      if (overlap_hi <= overlap_lo)
+        return 0;
+
+      area *= overlap_hi - overlap_lo;
+    }
+  }
+
+  return touching_dir == 3 ? 0 : area;
+}
+
+bool areFaceAdjacent(const SplitBlock& lhs, const SplitBlock& rhs)
+{
+  return computeSharedFaceArea(lhs, rhs) > 0;
+}
+
+std::vector<BlockAdjacency> computeBlockAdjacency(const std::vector<SplitBlock>& blocks)
+{
+  // Two blocks can only share a face if the upper face of one is at the same position (in the same
+  // MeshBlock and direction) as the lower face of the other.  The faces are bucketed by position,
+  // and the faces within each bucket are swept along one of the tangential directions, so the
+  // cost is O(F log F) in the number of faces rather than quadratic in the blocks per MeshBlock
+  struct Face
+  {
+    const MeshBlock* meshblock;
+    UInt dir;
+    UInt position;
+    bool is_upper;
+    UInt block;
+  };
+
+  std::vector<Face> faces;
+  faces.reserve(6 * blocks.size());
+  for (UInt i=0; i < blocks.size(); ++i)
+    for (UInt dir=0; dir < 3; ++dir)
+    {
+      faces.push_back({blocks[i].meshblock.get(), dir, blocks[i].mesh_offsets[dir], false, i});
+      faces.push_back({blocks[i].meshblock.get(), dir, blocks[i].mesh_offsets[dir] + blocks[i].element_counts[dir], true, i});
+    }
+
+  auto getStart = [&](UInt block, UInt dir) { return blocks[block].mesh_offsets[dir]; };
+  auto getEnd   = [&](UInt block, UInt dir) { return blocks[block].mesh_offsets[dir] + blocks[block].element_counts[dir]; };
+
+  // within a bucket, faces are ordered by their start in the first tangential direction
+  auto compareFaces = [&](const Face& lhs, const Face& rhs)
+  {
+    if (lhs.meshblock != rhs.meshblock)
+      return std::less<const MeshBlock*>()(lhs.meshblock, rhs.meshblock);
+    if (lhs.dir != rhs.dir)
+      return lhs.dir < rhs.dir;
+    if (lhs.position != rhs.position)
+      return lhs.position < rhs.position;
+
+    UInt tangential_dir = (lhs.dir + 1) % 3;
+    return getStart(lhs.block, tangential_dir) < getStart(rhs.block, tangential_dir);
+  };
+  std::sort(faces.begin(), faces.end(), compareFaces);
+
+  std::vector<BlockAdjacency> adjacency;
+  std::vector<UInt> active_lower, active_upper;
+  UInt bucket_start = 0;
+  while (bucket_start < faces.size())
+  {
+    const Face& first_face = faces[bucket_start];
+    UInt bucket_end = bucket_start + 1;
+    while (bucket_end < faces.size() && faces[bucket_end].meshblock == first_face.meshblock &&
+           faces[bucket_end].dir == first_face.dir && faces[bucket_end].position == first_face.position)
+      bucket_end++;
+
+    UInt dir_a = (first_face.dir + 1) % 3, dir_b = (first_face.dir + 2) % 3;
+    active_lower.clear();
+    active_upper.clear();
+    for (UInt f=bucket_start; f < bucket_end; ++f)
+    {
+      UInt block = faces[f].block;
+      UInt start_a = getStart(block, dir_a);
+      auto isFinished = [&](UInt other) { return getEnd(other, dir_a) <= start_a; };
+      active_lower.erase(std::remove_if(active_lower.begin(), active_lower.end(), isFinished), active_lower.end());
+      active_upper.erase(std::remove_if(active_upper.begin(), active_upper.end(), isFinished), active_upper.end());
+
+      // the upper face of one block touches the lower face of the other
+      for (UInt other : faces[f].is_upper ? active_lower : active_upper)
+      {
+        UInt overlap_b = std::min(getEnd(block, dir_b), getEnd(other, dir_b));
+        UInt start_b = std::max(getStart(block, dir_b), getStart(other, dir_b));
+        if (overlap_b <= start_b)
+          continue;
+
+        UInt overlap_a = std::min(getEnd(block, dir_a), getEnd(other, dir_a)) - start_a;
+        adjacency.push_back({std::min(block, other), std::max(block, other), overlap_a * (overlap_b - start_b)});
+      }
+
+      (faces[f].is_upper ? active_upper : active_lower).push_back(block);
+    }
+
+    bucket_start = bucket_end;
+  }
+
+  std::sort(adjacency.begin(), adjacency.end(), [](const BlockAdjacency& lhs, const BlockAdjacency& rhs)
+  {
+    return std::make_pair(lhs.block1, lhs.block2) < std::make_pair(rhs.block1, rhs.block2);
+  });
+
+  return adjacency;
+}
+
+}
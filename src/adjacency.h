@@ -0,0 +1,30 @@
+#ifndef STRUCTURED_PART_ADJACENCY_H
+#define STRUCTURED_PART_ADJACENCY_H
+
+#include "blocks.h"
+#include <vector>
+
+namespace structured_part {
+
+struct BlockAdjacency
+{
+  UInt block1;
+  UInt block2;
+  UInt area;
+};
+
+// returns the number of element faces shared by two blocks.  Blocks with different
+// parent MeshBlocks are never adjacent (there is no connectivity information between
+// MeshBlocks).  Returns 0 if the blocks are not face-adjacent
+UInt computeSharedFaceArea(const SplitBlock& lhs, const SplitBlock& rhs);
+
+// returns true if the two blocks have the same parent and share at least one face
+bool areFaceAdjacent(const SplitBlock& lhs, const SplitBlock& rhs);
+
+// computes all pairs of face-adjacent blocks, with block1 < block2, sorted by block1 and then block2.
+// The cost is O(B log B) in the number of blocks B, unless many blocks share a long thin face
+std::vector<BlockAdjacency> computeBlockAdjacency(const std::vector<SplitBlock>& blocks);
+
+}
+
+#endif
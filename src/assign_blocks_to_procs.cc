@@ -1,7 +1,9 @@
 #include "assign_blocks_to_procs.h"
+#include "adjacency.h"
 
 #include <limits>
 #include <algorithm>
+#include <numeric>
 
 namespace structured_part {
 
@@ -73,18 +75,83 @@ std::vector<std::vector<SplitBlock>> assignBlocksToProcs(std::vector<SplitBlock>
   return blocks_on_proc;
 }
 
+bool canAssignToProc(const std::vector<SplitBlock>& blocks_on_proc, const SplitBlock& block, bool allow_non_adjacent_siblings)
+{
+  for (const SplitBlock& other_block : blocks_on_proc)
+    if (other_block.meshblock == block.meshblock && (!allow_non_adjacent_siblings || areFaceAdjacent(other_block, block)))
+      return false;
+
+  return true;
+}
+
+namespace {
+
+template <typename T>
+std::vector<std::vector<SplitBlock>> assignBlocksToProcsByWeight(const std::vector<SplitBlock>& split_blocks, const std::vector<T>& weights,
+                                                                 UInt nprocs, bool allow_non_adjacent_siblings)
+{
+  assert(weights.size() == split_blocks.size());
+
+  // largest first
+  std::vector<UInt> idxs(split_blocks.size());
+  std::iota(idxs.begin(), idxs.end(), 0);
+  auto isHeavier = [&](UInt lhs, UInt rhs)
+  {
+    return weights[lhs] > weights[rhs] || (weights[lhs] == weights[rhs] && lhs < rhs);
+  };
+  std::sort(idxs.begin(), idxs.end(), isHeavier);
+
+  std::vector<std::vector<SplitBlock>> blocks_on_proc(nprocs);
+  std::vector<T> weight_on_proc(nprocs, 0);
+  for (UInt idx : idxs)
+  {
+    const SplitBlock& next_block = split_blocks[idx];
+    UInt min_proc = -1;
+    for (UInt proc=0; proc < nprocs; ++proc)
+    {
+      if (min_proc != UInt(-1) && weight_on_proc[proc] >= weight_on_proc[min_proc])
+        continue;
+
+      if (canAssignToProc(blocks_on_proc[proc], next_block, allow_non_adjacent_siblings))
+        min_proc = proc;
+    }
+
+    if (min_proc == UInt(-1))
+      throw std::runtime_error("unable to assign block to proc");
+
+    blocks_on_proc[min_proc].push_back(next_block);
+    weight_on_proc[min_proc] += weights[idx];
+  }
+
+  return blocks_on_proc;
+}
+
+}
+
+std::vector<std::vector<SplitBlock>> assignBlocksToProcs(const std::vector<SplitBlock>& split_blocks, const std::vector<IntWeight>& weights,
+                                                         UInt nprocs, bool allow_non_adjacent_siblings)
+{
+  return assignBlocksToProcsByWeight(split_blocks, weights, nprocs, allow_non_adjacent_siblings);
+}
+
+std::vector<std::vector<SplitBlock>> assignBlocksToProcs(const std::vector<SplitBlock>& split_blocks, const std::vector<double>& weights,
+                                                         UInt nprocs, bool allow_non_adjacent_siblings)
+{
+  return assignBlocksToProcsByWeight(split_blocks, weights, nprocs, allow_non_adjacent_siblings);
+}
+
 void printBlockAssigments(std::ostream& os, const std::vector<std::vector<SplitBlock>>& blocks_on_procs)
 {
   for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
   {
-    std::cout << "\nproc " << proc << std::endl;
+    os << "\nproc " << proc << std::endl;
     double weight = 0.0;
     for (const SplitBlock& split_block : blocks_on_procs[proc])
     {
-      std::cout << split_block << std::endl; 
+      os << split_block << std::endl;
       weight += split_block.weight;
     }
-    std::cout << "proc total weight = " << weight << std::endl;
+    os << "proc total weight = " << weight << std::endl;
   }
 }
 
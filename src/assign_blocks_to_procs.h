@@ -11,6 +11,20 @@ UInt getProcWithMinWeightAndDifferentParent(const std::vector<std::vector<SplitB
 
 std::vector<std::vector<SplitBlock>> assignBlocksToProcs(std::vector<SplitBlock> split_blocks, UInt nprocs);
 
+// same as above, but uses the given integer weights (entry i is for split_blocks[i]).  Ties are broken
+// by position in split_blocks, so the result does not depend on the sort implementation.
+// If allow_non_adjacent_siblings is true, a proc may get several sub-blocks of the same MeshBlock
+// as long as they are not face-adjacent (see PartitionOptions)
+std::vector<std::vector<SplitBlock>> assignBlocksToProcs(const std::vector<SplitBlock>& split_blocks, const std::vector<IntWeight>& weights,
+                                                         UInt nprocs, bool allow_non_adjacent_siblings=false);
+
+// same as above, but for floating point weights (ex. modeled costs, see cost_model.h)
+std::vector<std::vector<SplitBlock>> assignBlocksToProcs(const std::vector<SplitBlock>& split_blocks, const std::vector<double>& weights,
+                                                         UInt nprocs, bool allow_non_adjacent_siblings=false);
+
+// returns true if block can be added to a proc that has blocks_on_proc
+bool canAssignToProc(const std::vector<SplitBlock>& blocks_on_proc, const SplitBlock& block, bool allow_non_adjacent_siblings);
+
 void printBlockAssigments(std::ostream& os, const std::vector<std::vector<SplitBlock>>& blocks_on_procs);
 
 }
@@ -0,0 +1,52 @@
+#include "block_file.h"
+#include <fstream>
+#include <sstream>
+
+namespace structured_part {
+
+std::vector<std::shared_ptr<MeshBlock>> readBlockFile(std::istream& is)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks;
+  std::string line;
+  UInt line_number = 0;
+  while (std::getline(is, line))
+  {
+    line_number++;
+    line = line.substr(0, line.find('#'));
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+
+    std::istringstream line_stream(line);
+    // read the sizes as signed values, because reading a negative number into an unsigned type
+    // wraps around rather than failing
+    Int block_id, nx, ny, nz;
+    if (!(line_stream >> block_id >> nx >> ny >> nz) || nx <= 0 || ny <= 0 || nz <= 0)
+      throw std::runtime_error("invalid block on line " + std::to_string(line_number));
+
+    double weight;
+    bool have_weight = static_cast<bool>(line_stream >> weight);
+    line_stream.clear();
+
+    std::string extra;
+    if (line_stream >> extra)
+      throw std::runtime_error("unexpected text on line " + std::to_string(line_number));
+
+    if (have_weight)
+      mesh_blocks.push_back(std::make_shared<MeshBlock>(block_id, nx, ny, nz, weight));
+    else
+      mesh_blocks.push_back(std::make_shared<MeshBlock>(block_id, nx, ny, nz));
+  }
+
+  return mesh_blocks;
+}
+
+std::vector<std::shared_ptr<MeshBlock>> readBlockFile(const std::string& fname)
+{
+  std::ifstream file(fname);
+  if (!file)
+    throw std::runtime_error("could not open file " + fname);
+
+  return readBlockFile(file);
+}
+
+}
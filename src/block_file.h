@@ -0,0 +1,20 @@
+#ifndef STRUCTURED_PART_BLOCK_FILE_H
+#define STRUCTURED_PART_BLOCK_FILE_H
+
+#include "blocks.h"
+#include <string>
+#include <vector>
+
+namespace structured_part {
+
+// reads a text file describing the mesh blocks.  Each line is of the form
+//   block_id nx ny nz [weight]
+// where nx, ny, and nz are the number of elements in each direction and the weight
+// defaults to nx*ny*nz.  Blank lines and anything after a # are ignored
+std::vector<std::shared_ptr<MeshBlock>> readBlockFile(std::istream& is);
+
+std::vector<std::shared_ptr<MeshBlock>> readBlockFile(const std::string& fname);
+
+}
+
+#endif
@@ -1,5 +1,9 @@
 #include "blocks.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
 
 namespace structured_part
 {
@@ -29,16 +33,8 @@ std::pair<SplitBlock, SplitBlock> splitBlock(const SplitBlock& splitBlock, Split
 
 std::pair<SplitBlock, SplitBlock> splitBlock(const SplitBlock& split_block)
 {
-  UInt max_dir = 0;
-  UInt max_elem_per_dir = split_block.element_counts[0];
-  for (UInt i=1; i < 3; ++i)
-  {
-    if (split_block.element_counts[i] > max_elem_per_dir)
-    {
-      max_dir = i;
-      max_elem_per_dir = split_block.element_counts[i];
-    }
-  }
+  UInt max_dir = getLongestDirection(split_block.element_counts);
+  UInt max_elem_per_dir = split_block.element_counts[max_dir];
 
   UInt nelem = std::floor(double(max_elem_per_dir) / 2);
 
@@ -50,16 +46,8 @@ std::pair<SplitBlock, SplitBlock> splitBlock(const SplitBlock& split_block, doub
   if (fraction < 0 || fraction > 1)
     throw std::runtime_error("fraction must be in the range [0, 1]");
 
-  UInt max_dir = 0;
-  UInt max_elem_per_dir = split_block.element_counts[0];
-  for (UInt i=1; i < 3; ++i)
-  {
-    if (split_block.element_counts[i] > max_elem_per_dir)
-    {
-      max_dir = i;
-      max_elem_per_dir = split_block.element_counts[i];
-    }
-  }
+  UInt max_dir = getLongestDirection(split_block.element_counts);
+  UInt max_elem_per_dir = split_block.element_counts[max_dir];
 
   UInt nelem_left = 0;
   if (fraction < 0.5)
@@ -73,4 +61,70 @@ std::pair<SplitBlock, SplitBlock> splitBlock(const SplitBlock& split_block, doub
   return splitBlock(split_block, static_cast<SplitDirection>(max_dir), nelem_left);
 }
 
-}
\ No newline at end of file
+namespace {
+
+double computeMaxAspectRatio(const std::array<UInt, 3>& lhs_counts, const std::array<UInt, 3>& rhs_counts, UInt dim)
+{
+  double max_ratio = 0;
+  for (const std::array<UInt, 3>& counts : {lhs_counts, rhs_counts})
+  {
+    UInt min_count = counts[0], max_count = counts[0];
+    for (UInt d=1; d < dim; ++d)
+    {
+      min_count = std::min(min_count, counts[d]);
+      max_count = std::max(max_count, counts[d]);
+    }
+    max_ratio = std::max(max_ratio, double(max_count) / min_count);
+  }
+
+  return max_ratio;
+}
+
+}
+
+std::vector<BlockCut> getCandidateCuts(const SplitBlock& split_block, double fraction, double max_aspect_ratio)
+{
+  if (fraction < 0 || fraction > 1)
+    throw std::runtime_error("fraction must be in the range [0, 1]");
+
+  const std::array<UInt, 3>& counts = split_block.element_counts;
+  UInt dim = getDimension(split_block.meshblock->element_counts);
+  std::vector<BlockCut> cuts, cuts_over_aspect_ratio;
+  for (UInt dir=0; dir < dim; ++dir)
+  {
+    if (counts[dir] < 2)
+      continue;
+
+    auto clampCount = [&](UInt nelem) { return std::min(std::max(nelem, UInt(1)), counts[dir] - 1); };
+    UInt nelem_floor = std::floor(counts[dir] * fraction);
+    for (UInt nelem=clampCount(nelem_floor); nelem <= clampCount(nelem_floor + 1); ++nelem)
+    {
+      std::array<UInt, 3> lhs_counts = counts, rhs_counts = counts;
+      lhs_counts[dir] = nelem;
+      rhs_counts[dir] = counts[dir] - nelem;
+      BlockCut cut{dir, nelem, prod(counts) / counts[dir]};
+      if (computeMaxAspectRatio(lhs_counts, rhs_counts, dim) <= max_aspect_ratio)
+        cuts.push_back(cut);
+      else
+        cuts_over_aspect_ratio.push_back(cut);
+    }
+  }
+
+  return cuts.size() > 0 ? cuts : cuts_over_aspect_ratio;
+}
+
+IntWeight computeElementCost(const MeshBlock& meshblock, UInt element_cost_scale)
+{
+  double cost = std::round(meshblock.weight * element_cost_scale / prod(meshblock.element_counts));
+  if (cost < 1 && meshblock.weight > 0)
+    throw std::runtime_error("element cost of block " + std::to_string(meshblock.block_id) + " rounds to zero, increase element_cost_scale");
+
+  return cost;
+}
+
+IntWeight computeIntegerWeight(const SplitBlock& block, UInt element_cost_scale)
+{
+  return prod(block.element_counts) * computeElementCost(*block.meshblock, element_cost_scale);
+}
+
+}
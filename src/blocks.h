@@ -5,9 +5,11 @@
 #include <memory>
 #include <cassert>
 #include <array>
+#include <cstdint>
 #include "array_helpers.h"
 
 #include <stdexcept>
+#include <vector>
 
 namespace structured_part {
 
@@ -93,6 +95,43 @@ enum class SplitDirection
   K
 };
 
+// returns 2 if the block has a single element in the k direction, 3 otherwise.
+// The split routines are specialized on the dimension so 2D blocks never look at k
+inline UInt getDimension(const std::array<UInt, 3>& element_counts)
+{
+  return element_counts[2] == 1 ? 2 : 3;
+}
+
+// returns the direction with the most elements among the first Dim directions.
+// Ties go to the lower direction
+template <UInt Dim>
+UInt getLongestDirection(const std::array<UInt, 3>& element_counts)
+{
+  UInt max_dir = 0;
+  for (UInt i=1; i < Dim; ++i)
+    if (element_counts[i] > element_counts[max_dir])
+      max_dir = i;
+
+  return max_dir;
+}
+
+inline UInt getLongestDirection(const std::array<UInt, 3>& element_counts)
+{
+  return getDimension(element_counts) == 2 ? getLongestDirection<2>(element_counts) :
+                                             getLongestDirection<3>(element_counts);
+}
+
+
+// weight in integer cost units, see WeightMode::Integer
+using IntWeight = uint64_t;
+
+// returns the cost of one element of the MeshBlock in integer units:
+// round(element_cost_scale * weight / number of elements).  Throws if a block with
+// non-zero weight would get zero cost
+IntWeight computeElementCost(const MeshBlock& meshblock, UInt element_cost_scale);
+
+// returns the number of elements in the block times the cost of an element of its MeshBlock
+IntWeight computeIntegerWeight(const SplitBlock& block, UInt element_cost_scale);
 
 // splits a block in the given direction.  Returns 2 blocks, one with elements [0, nelem) from the original
 // block in the given direction, and one with [nelem, splitBlock->element_counts] in the given direction
@@ -106,6 +145,19 @@ std::pair<SplitBlock, SplitBlock> splitBlock(const SplitBlock& splitBlock);
 // the elements
 std::pair<SplitBlock, SplitBlock> splitBlock(const SplitBlock& splitBlock, double fraction);
 
+// a cut of a block into the elements [0, nelem) and [nelem, element_counts[dir]) in direction dir
+struct BlockCut
+{
+  UInt dir;
+  UInt nelem;
+  UInt area;  // number of element faces on the cut
+};
+
+// returns the cuts in every direction at the element counts on either side of the given fraction
+// of the elements.  Cuts that create a block with an aspect ratio greater than max_aspect_ratio are
+// left out, unless every cut would
+std::vector<BlockCut> getCandidateCuts(const SplitBlock& splitBlock, double fraction, double max_aspect_ratio);
+
 
 
 }  // namespace
@@ -0,0 +1,174 @@
+#include "calibrate.h"
+#include <cmath>
+#include <unordered_map>
+
+namespace structured_part {
+
+namespace {
+
+// solves the symmetric positive definite system A x = b in place using a Cholesky
+// factorization.  A is stored row major
+std::vector<double> solveSPD(std::vector<double> A, std::vector<double> b)
+{
+  UInt n = b.size();
+  for (UInt j=0; j < n; ++j)
+  {
+    double diag = A[j*n + j];
+    for (UInt k=0; k < j; ++k)
+      diag -= A[j*n + k] * A[j*n + k];
+
+    if (!(diag > 0))
+      throw std::runtime_error("calibration least squares problem is singular");
+
+    diag = std::sqrt(diag);
+    A[j*n + j] = diag;
+    for (UInt i=j+1; i < n; ++i)
+    {
+      double val = A[i*n + j];
+      for (UInt k=0; k < j; ++k)
+        val -= A[i*n + k] * A[j*n + k];
+      A[i*n + j] = val / diag;
+    }
+  }
+
+  // forward and back substitution with L and L^T
+  for (UInt i=0; i < n; ++i)
+  {
+    for (UInt k=0; k < i; ++k)
+      b[i] -= A[i*n + k] * b[k];
+    b[i] /= A[i*n + i];
+  }
+
+  for (UInt i=n; i-- > 0; )
+  {
+    for (UInt k=i+1; k < n; ++k)
+      b[i] -= A[k*n + i] * b[k];
+    b[i] /= A[i*n + i];
+  }
+
+  return b;
+}
+
+}
+
+WeightCalibration calibrateWeights(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks,
+                                   const std::vector<std::vector<SplitBlock>>& blocks_on_procs,
+                                   const std::vector<double>& times_per_rank,
+                                   const CalibrationOptions& options)
+{
+  if (times_per_rank.size() != blocks_on_procs.size())
+    throw std::runtime_error("times_per_rank must have one entry per rank");
+
+  std::unordered_map<const MeshBlock*, UInt> meshblock_idxs;
+  double total_weight = 0, total_time = 0;
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+  {
+    if (!(mesh_blocks[i]->weight > 0))
+      throw std::runtime_error("calibration requires MeshBlocks with positive weight");
+
+    meshblock_idxs[mesh_blocks[i].get()] = i;
+    total_weight += mesh_blocks[i]->weight;
+  }
+
+  for (double time : times_per_rank)
+    total_time += time;
+
+  if (!(total_time > 0))
+    throw std::runtime_error("calibration requires positive rank times");
+
+  // The unknowns are the multipliers of the current weights of the MeshBlocks, scaled so the
+  // current weights fit the total time, followed by the overhead per block.  Column j of the
+  // least squares matrix is the predicted time of each rank for unknown j
+  double time_per_weight = total_time / total_weight;
+  UInt nmesh = mesh_blocks.size();
+  UInt nunknowns = nmesh + (options.fit_block_overhead ? 1 : 0);
+  std::vector<double> AtA(nunknowns * nunknowns, 0.0), Atb(nunknowns, 0.0);
+  std::vector<double> row(nunknowns);
+  std::vector<UInt> nonzeros;
+  for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
+  {
+    nonzeros.clear();
+    for (const SplitBlock& block : blocks_on_procs[proc])
+    {
+      auto it = meshblock_idxs.find(block.meshblock.get());
+      if (it == meshblock_idxs.end())
+        throw std::runtime_error("decomposition has a SplitBlock whose MeshBlock is not in mesh_blocks");
+
+      if (row[it->second] == 0)
+        nonzeros.push_back(it->second);
+      row[it->second] += time_per_weight * block.weight;
+    }
+
+    if (options.fit_block_overhead && blocks_on_procs[proc].size() > 0)
+    {
+      row[nmesh] = blocks_on_procs[proc].size();
+      nonzeros.push_back(nmesh);
+    }
+
+    for (UInt i : nonzeros)
+    {
+      for (UInt j : nonzeros)
+        AtA[i*nunknowns + j] += row[i] * row[j];
+      Atb[i] += row[i] * times_per_rank[proc];
+    }
+
+    for (UInt i : nonzeros)
+      row[i] = 0;
+  }
+
+  // regularize the multipliers towards 1 and the overhead towards 0.  Unknowns that do not
+  // appear in the problem (a MeshBlock that is not in the decomposition) keep their current value
+  for (UInt i=0; i < nunknowns; ++i)
+  {
+    double diag = AtA[i*nunknowns + i];
+    double lambda = diag > 0 ? options.regularization * diag : 1;
+    AtA[i*nunknowns + i] += lambda;
+    if (i < nmesh)
+      Atb[i] += lambda;
+  }
+
+  std::vector<double> x = solveSPD(AtA, Atb);
+
+  // the fit can give non-physical negative values when the data is noisy
+  constexpr double min_multiplier = 1e-3;
+  double fitted_time = 0;
+  for (UInt i=0; i < nmesh; ++i)
+  {
+    x[i] = std::max(x[i], min_multiplier);
+    fitted_time += x[i] * time_per_weight * mesh_blocks[i]->weight;
+  }
+  double overhead = options.fit_block_overhead ? std::max(x[nmesh], 0.0) : 0.0;
+
+  // convert from time back to weight units, preserving the total weight
+  double weight_per_time = total_weight / fitted_time;
+  WeightCalibration calibration;
+  calibration.weights.resize(nmesh);
+  for (UInt i=0; i < nmesh; ++i)
+    calibration.weights[i] = x[i] * time_per_weight * mesh_blocks[i]->weight * weight_per_time;
+  calibration.cost_model.per_block = overhead * weight_per_time;
+
+  double sum_squares = 0;
+  for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
+  {
+    double predicted_time = 0;
+    for (const SplitBlock& block : blocks_on_procs[proc])
+      predicted_time += x[meshblock_idxs[block.meshblock.get()]] * time_per_weight * block.weight + overhead;
+
+    sum_squares += std::pow(predicted_time - times_per_rank[proc], 2);
+  }
+  double avg_time = total_time / times_per_rank.size();
+  calibration.rms_relative_residual = std::sqrt(sum_squares / times_per_rank.size()) / avg_time;
+
+  return calibration;
+}
+
+void applyCalibration(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, const WeightCalibration& calibration)
+{
+  if (calibration.weights.size() != mesh_blocks.size())
+    throw std::runtime_error("calibration has a different number of MeshBlocks than mesh_blocks");
+
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+    mesh_blocks[i]->weight = calibration.weights[i];
+}
+
+}
@@ -0,0 +1,45 @@
+#ifndef STRUCTURED_PART_CALIBRATE_H
+#define STRUCTURED_PART_CALIBRATE_H
+
+#include "blocks.h"
+#include "cost_model.h"
+#include <vector>
+
+namespace structured_part {
+
+struct CalibrationOptions
+{
+  // also fit a fixed time per sub-block, which is returned as CostModel::per_block
+  bool fit_block_overhead = false;
+
+  // the fit is regularized towards the current weights, relative to the size of the
+  // least squares problem.  This keeps the fit well posed when there are more MeshBlocks
+  // than ranks, or when a MeshBlock is always on the same ranks as another MeshBlock
+  double regularization = 1e-3;
+};
+
+struct WeightCalibration
+{
+  std::vector<double> weights;  // new weight of each MeshBlock, entry i is for mesh_blocks[i]
+  CostModel cost_model;         // per_block is the fitted overhead, in the same units as weights
+  double rms_relative_residual; // of the fitted rank times, relative to the average rank time
+};
+
+// fits the time of each rank of a previous run, given by times_per_rank, as the sum over its
+// SplitBlocks of (number of elements) * (time per element of the parent MeshBlock), plus an
+// optional overhead per SplitBlock, by least squares over the ranks.  blocks_on_procs is the
+// decomposition of the previous run, and its MeshBlocks must be in mesh_blocks.
+// The returned weights are scaled so their sum is the sum of the current weights, so they can
+// be assigned to MeshBlock::weight and passed (with cost_model) to the next partitionMesh.
+// Repeating this over several runs makes the imbalance converge
+WeightCalibration calibrateWeights(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks,
+                                   const std::vector<std::vector<SplitBlock>>& blocks_on_procs,
+                                   const std::vector<double>& times_per_rank,
+                                   const CalibrationOptions& options = CalibrationOptions());
+
+// assigns the weights from calibrateWeights to the MeshBlocks
+void applyCalibration(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, const WeightCalibration& calibration);
+
+}
+
+#endif
@@ -0,0 +1,416 @@
+#include "compact_decomp.h"
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <type_traits>
+
+namespace structured_part {
+
+namespace {
+
+// chooses the cut coordinates in direction dir.  A coordinate is used as a cut if more blocks
+// start at it than cross it, which picks out the cuts of the regular grids created by
+// createSplitBlocks while ignoring the cuts of the (fewer) remainder and final split blocks
+std::vector<CompactDecomposition::CoordType> computeCuts(const std::vector<std::pair<CompactDecomposition::RankType, const SplitBlock*>>& blocks,
+                                                         UInt num_elements, UInt dir)
+{
+  std::vector<UInt> lower_bounds, upper_bounds;
+  for (auto& [rank, block] : blocks)
+  {
+    lower_bounds.push_back(block->mesh_offsets[dir]);
+    upper_bounds.push_back(block->mesh_offsets[dir] + block->element_counts[dir]);
+  }
+  std::sort(lower_bounds.begin(), lower_bounds.end());
+  std::sort(upper_bounds.begin(), upper_bounds.end());
+
+  std::vector<CompactDecomposition::CoordType> cuts = {0};
+  UInt idx = 0;
+  while (idx < lower_bounds.size())
+  {
+    UInt coord = lower_bounds[idx];
+    UInt num_starting = 0;
+    while (idx < lower_bounds.size() && lower_bounds[idx] == coord)
+    {
+      num_starting++;
+      idx++;
+    }
+
+    // blocks with lower bound < coord that end after coord
+    UInt num_before = std::lower_bound(lower_bounds.begin(), lower_bounds.end(), coord) - lower_bounds.begin();
+    UInt num_ended = std::upper_bound(upper_bounds.begin(), upper_bounds.end(), coord) - upper_bounds.begin();
+    UInt num_crossing = num_before - num_ended;
+
+    if (coord > 0 && coord < num_elements && num_starting > num_crossing)
+      cuts.push_back(coord);
+  }
+  cuts.push_back(num_elements);
+
+  return cuts;
+}
+
+// returns the index of the cell that starts at lower and ends at upper, or -1 if there is
+// no such cell
+UInt findCell(const std::vector<CompactDecomposition::CoordType>& cuts, UInt lower, UInt upper)
+{
+  auto it = std::lower_bound(cuts.begin(), cuts.end(), lower);
+  if (it == cuts.end() || *it != lower || it + 1 == cuts.end() || *(it + 1) != upper)
+    return -1;
+
+  return it - cuts.begin();
+}
+
+}
+
+CompactDecomposition::CompactDecomposition(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks,
+                                           const std::vector<std::vector<SplitBlock>>& blocks_on_procs) :
+  m_nprocs(blocks_on_procs.size())
+{
+  if (m_nprocs >= NoRank)
+    throw std::runtime_error("too many procs for CompactDecomposition");
+
+  std::map<const MeshBlock*, UInt> meshblock_idxs;
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+    meshblock_idxs[mesh_blocks[i].get()] = i;
+
+  std::vector<std::vector<std::pair<RankType, const SplitBlock*>>> blocks_per_meshblock(mesh_blocks.size());
+  for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
+    for (const SplitBlock& split_block : blocks_on_procs[proc])
+    {
+      auto it = meshblock_idxs.find(split_block.meshblock.get());
+      if (it == meshblock_idxs.end())
+        throw std::runtime_error("SplitBlock has a MeshBlock that is not in mesh_blocks");
+
+      blocks_per_meshblock[it->second].emplace_back(proc, &split_block);
+    }
+
+  m_encodings.resize(mesh_blocks.size());
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+  {
+    m_encodings[i].meshblock = mesh_blocks[i];
+    encodeMeshBlock(m_encodings[i], blocks_per_meshblock[i]);
+    m_num_blocks += blocks_per_meshblock[i].size();
+  }
+}
+
+void CompactDecomposition::encodeMeshBlock(BlockEncoding& encoding, const std::vector<std::pair<RankType, const SplitBlock*>>& blocks)
+{
+  for (UInt d=0; d < 3; ++d)
+  {
+    if (encoding.meshblock->element_counts[d] > std::numeric_limits<CoordType>::max())
+      throw std::runtime_error("MeshBlock is too large for CompactDecomposition");
+
+    encoding.cuts[d] = computeCuts(blocks, encoding.meshblock->element_counts[d], d);
+  }
+
+  // don't let the grid get much larger than the number of blocks
+  std::array<UInt, 3> num_cells = getCellCounts(encoding);
+  if (prod(num_cells) > 2*blocks.size() + 8)
+  {
+    for (UInt d=0; d < 3; ++d)
+      encoding.cuts[d] = {0, CoordType(encoding.meshblock->element_counts[d])};
+    num_cells = {1, 1, 1};
+  }
+
+  encoding.cell_ranks.assign(prod(num_cells), NoRank);
+  for (auto& [rank, block] : blocks)
+  {
+    std::array<UInt, 3> cell;
+    bool is_cell = true;
+    for (UInt d=0; d < 3; ++d)
+    {
+      cell[d] = findCell(encoding.cuts[d], block->mesh_offsets[d], block->mesh_offsets[d] + block->element_counts[d]);
+      is_cell = is_cell && cell[d] != UInt(-1);
+    }
+
+    if (is_cell)
+    {
+      UInt idx = cell[0]*num_cells[1]*num_cells[2] + cell[1]*num_cells[2] + cell[2];
+      encoding.cell_ranks[idx] = rank;
+    } else
+    {
+      Exception exception;
+      for (UInt d=0; d < 3; ++d)
+      {
+        exception.element_counts[d] = block->element_counts[d];
+        exception.mesh_offsets[d]   = block->mesh_offsets[d];
+      }
+      exception.rank = rank;
+      encoding.exceptions.push_back(exception);
+    }
+  }
+
+  encoding.exceptions.shrink_to_fit();
+}
+
+std::array<UInt, 3> CompactDecomposition::getCellCounts(const BlockEncoding& encoding) const
+{
+  return {encoding.cuts[0].size() - 1, encoding.cuts[1].size() - 1, encoding.cuts[2].size() - 1};
+}
+
+CompactDecomposition::RankType CompactDecomposition::getRank(UInt meshblock_idx, UInt slot) const
+{
+  const BlockEncoding& encoding = m_encodings[meshblock_idx];
+  if (slot < encoding.cell_ranks.size())
+    return encoding.cell_ranks[slot];
+  else
+    return encoding.exceptions[slot - encoding.cell_ranks.size()].rank;
+}
+
+SplitBlock CompactDecomposition::getBlock(UInt meshblock_idx, UInt slot) const
+{
+  const BlockEncoding& encoding = m_encodings[meshblock_idx];
+  std::array<UInt, 3> element_counts, mesh_offsets;
+  if (slot < encoding.cell_ranks.size())
+  {
+    std::array<UInt, 3> num_cells = getCellCounts(encoding);
+    std::array<UInt, 3> cell = {slot / (num_cells[1]*num_cells[2]), (slot / num_cells[2]) % num_cells[1], slot % num_cells[2]};
+    for (UInt d=0; d < 3; ++d)
+    {
+      mesh_offsets[d]   = encoding.cuts[d][cell[d]];
+      element_counts[d] = encoding.cuts[d][cell[d] + 1] - encoding.cuts[d][cell[d]];
+    }
+  } else
+  {
+    const Exception& exception = encoding.exceptions[slot - encoding.cell_ranks.size()];
+    for (UInt d=0; d < 3; ++d)
+    {
+      mesh_offsets[d]   = exception.mesh_offsets[d];
+      element_counts[d] = exception.element_counts[d];
+    }
+  }
+
+  return SplitBlock(encoding.meshblock, element_counts, mesh_offsets);
+}
+
+CompactDecomposition::RankType CompactDecomposition::getOwner(UInt meshblock_idx, const std::array<UInt, 3>& element) const
+{
+  const BlockEncoding& encoding = m_encodings[meshblock_idx];
+  std::array<UInt, 3> num_cells = getCellCounts(encoding);
+  std::array<UInt, 3> cell;
+  for (UInt d=0; d < 3; ++d)
+  {
+    if (element[d] >= encoding.meshblock->element_counts[d])
+      throw std::runtime_error("element is not in MeshBlock");
+
+    cell[d] = std::upper_bound(encoding.cuts[d].begin(), encoding.cuts[d].end(), element[d]) - encoding.cuts[d].begin() - 1;
+  }
+
+  RankType rank = encoding.cell_ranks[cell[0]*num_cells[1]*num_cells[2] + cell[1]*num_cells[2] + cell[2]];
+  if (rank != NoRank)
+    return rank;
+
+  for (const Exception& exception : encoding.exceptions)
+  {
+    bool contains = true;
+    for (UInt d=0; d < 3; ++d)
+      contains = contains && element[d] >= exception.mesh_offsets[d] &&
+                 element[d] < exception.mesh_offsets[d] + exception.element_counts[d];
+
+    if (contains)
+      return exception.rank;
+  }
+
+  return NoRank;
+}
+
+void CompactDecomposition::forEachBlock(const std::function<void(UInt rank, const SplitBlock& block)>& func) const
+{
+  for (UInt i=0; i < m_encodings.size(); ++i)
+    for (UInt slot=0; slot < getNumSlots(i); ++slot)
+      if (hasBlock(i, slot))
+        func(getRank(i, slot), getBlock(i, slot));
+}
+
+std::vector<std::vector<SplitBlock>> CompactDecomposition::expand() const
+{
+  std::vector<std::vector<SplitBlock>> blocks_on_procs(m_nprocs);
+  forEachBlock([&](UInt rank, const SplitBlock& block) { blocks_on_procs[rank].push_back(block); });
+
+  return blocks_on_procs;
+}
+
+UInt CompactDecomposition::getMemoryUsage() const
+{
+  UInt num_bytes = sizeof(CompactDecomposition) + m_encodings.capacity() * sizeof(BlockEncoding);
+  for (const BlockEncoding& encoding : m_encodings)
+  {
+    for (UInt d=0; d < 3; ++d)
+      num_bytes += encoding.cuts[d].capacity() * sizeof(CoordType);
+
+    num_bytes += encoding.cell_ranks.capacity() * sizeof(RankType);
+    num_bytes += encoding.exceptions.capacity() * sizeof(Exception);
+  }
+
+  return num_bytes;
+}
+
+// The format is
+//   structured_part_decomposition <nprocs> <number of MeshBlocks>
+// followed by, for each MeshBlock,
+//   meshblock <block_id> <nx> <ny> <nz> <weight>
+//   cuts <number of cuts> <cuts...>           (once for each direction)
+//   ranks <number of cells> <ranks...>        (-1 for cells that are not a block)
+//   exceptions <number of exceptions>
+//   <nx> <ny> <nz> <offset x> <offset y> <offset z> <rank>    (once for each exception)
+void CompactDecomposition::write(std::ostream& os) const
+{
+  os << "structured_part_decomposition " << m_nprocs << " " << m_encodings.size() << "\n";
+  for (const BlockEncoding& encoding : m_encodings)
+  {
+    const MeshBlock& meshblock = *encoding.meshblock;
+    os << "meshblock " << meshblock.block_id << " " << meshblock.element_counts[0] << " " << meshblock.element_counts[1]
+       << " " << meshblock.element_counts[2] << " " << std::setprecision(17) << meshblock.weight << "\n";
+
+    for (UInt d=0; d < 3; ++d)
+    {
+      os << "cuts " << encoding.cuts[d].size();
+      for (CoordType cut : encoding.cuts[d])
+        os << " " << cut;
+      os << "\n";
+    }
+
+    os << "ranks " << encoding.cell_ranks.size();
+    for (RankType rank : encoding.cell_ranks)
+      os << " " << (rank == NoRank ? -1 : Int(rank));
+    os << "\n";
+
+    os << "exceptions " << encoding.exceptions.size() << "\n";
+    for (const Exception& exception : encoding.exceptions)
+      os << exception.element_counts[0] << " " << exception.element_counts[1] << " " << exception.element_counts[2] << " "
+         << exception.mesh_offsets[0] << " " << exception.mesh_offsets[1] << " " << exception.mesh_offsets[2] << " "
+         << exception.rank << "\n";
+  }
+}
+
+namespace {
+
+void readKeyword(std::istream& is, const std::string& expected_keyword)
+{
+  std::string keyword;
+  if (!(is >> keyword) || keyword != expected_keyword)
+    throw std::runtime_error("error reading decomposition: expected " + expected_keyword);
+}
+
+template <typename T>
+T readValue(std::istream& is)
+{
+  if constexpr (std::is_unsigned_v<T>)
+  {
+    // reading a negative number into an unsigned type wraps around rather than failing
+    long long val;
+    if (!(is >> val) || val < 0 || static_cast<unsigned long long>(val) > std::numeric_limits<T>::max())
+      throw std::runtime_error("error reading decomposition");
+
+    return static_cast<T>(val);
+  } else
+  {
+    T val;
+    if (!(is >> val))
+      throw std::runtime_error("error reading decomposition");
+
+    return val;
+  }
+}
+
+// reads a count of values that is at most max_count.  Checking the count before resizing keeps a
+// corrupt file from allocating an arbitrary amount of memory
+UInt readCount(std::istream& is, UInt max_count)
+{
+  UInt count = readValue<UInt>(is);
+  if (count > max_count)
+    throw std::runtime_error("error reading decomposition: invalid count");
+
+  return count;
+}
+
+}
+
+CompactDecomposition CompactDecomposition::read(std::istream& is)
+{
+  CompactDecomposition decomp;
+  readKeyword(is, "structured_part_decomposition");
+  decomp.m_nprocs = readCount(is, NoRank - 1);
+
+  // the MeshBlocks are read one at a time rather than resizing m_encodings up front, so a
+  // corrupt count fails at the end of the file
+  UInt num_meshblocks = readValue<UInt>(is);
+  for (UInt i=0; i < num_meshblocks; ++i)
+  {
+    BlockEncoding encoding;
+    readKeyword(is, "meshblock");
+    Int block_id = readValue<Int>(is);
+    std::array<UInt, 3> element_counts;
+    for (UInt d=0; d < 3; ++d)
+    {
+      element_counts[d] = readCount(is, std::numeric_limits<CoordType>::max());
+      if (element_counts[d] == 0)
+        throw std::runtime_error("error reading decomposition: invalid MeshBlock size");
+    }
+    double weight = readValue<double>(is);
+    encoding.meshblock = std::make_shared<MeshBlock>(block_id, element_counts[0], element_counts[1], element_counts[2], weight);
+
+    for (UInt d=0; d < 3; ++d)
+    {
+      readKeyword(is, "cuts");
+      encoding.cuts[d].resize(readCount(is, element_counts[d] + 1));
+      for (CoordType& cut : encoding.cuts[d])
+        cut = readValue<CoordType>(is);
+
+      if (encoding.cuts[d].size() < 2 || encoding.cuts[d].front() != 0 || encoding.cuts[d].back() != element_counts[d] ||
+          std::adjacent_find(encoding.cuts[d].begin(), encoding.cuts[d].end(), std::greater_equal<CoordType>()) != encoding.cuts[d].end())
+        throw std::runtime_error("error reading decomposition: invalid cuts");
+    }
+
+    readKeyword(is, "ranks");
+    UInt num_cells = prod(decomp.getCellCounts(encoding));
+    if (readValue<UInt>(is) != num_cells)
+      throw std::runtime_error("error reading decomposition: wrong number of cells");
+
+    encoding.cell_ranks.resize(num_cells);
+    for (RankType& rank : encoding.cell_ranks)
+    {
+      Int val = readValue<Int>(is);
+      if (val < -1 || val >= Int(decomp.m_nprocs))
+        throw std::runtime_error("error reading decomposition: invalid rank");
+
+      rank = val == -1 ? NoRank : RankType(val);
+      decomp.m_num_blocks += rank != NoRank;
+    }
+
+    // every exception has at least one element
+    readKeyword(is, "exceptions");
+    encoding.exceptions.resize(readCount(is, prod(element_counts)));
+    for (Exception& exception : encoding.exceptions)
+    {
+      for (UInt d=0; d < 3; ++d)
+        exception.element_counts[d] = readValue<CoordType>(is);
+      for (UInt d=0; d < 3; ++d)
+        exception.mesh_offsets[d] = readValue<CoordType>(is);
+      exception.rank = readValue<RankType>(is);
+
+      for (UInt d=0; d < 3; ++d)
+        if (exception.element_counts[d] == 0 || UInt(exception.mesh_offsets[d]) + exception.element_counts[d] > element_counts[d])
+          throw std::runtime_error("error reading decomposition: exception is outside the MeshBlock");
+
+      if (exception.rank >= decomp.m_nprocs)
+        throw std::runtime_error("error reading decomposition: invalid rank");
+    }
+    decomp.m_num_blocks += encoding.exceptions.size();
+    decomp.m_encodings.push_back(std::move(encoding));
+  }
+
+  return decomp;
+}
+
+UInt computeMemoryUsage(const std::vector<std::vector<SplitBlock>>& blocks_on_procs)
+{
+  UInt num_bytes = sizeof(blocks_on_procs) + blocks_on_procs.capacity() * sizeof(std::vector<SplitBlock>);
+  for (const std::vector<SplitBlock>& blocks : blocks_on_procs)
+    num_bytes += blocks.capacity() * sizeof(SplitBlock);
+
+  return num_bytes;
+}
+
+}
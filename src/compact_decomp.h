@@ -0,0 +1,106 @@
+#ifndef STRUCTURED_PART_COMPACT_DECOMP_H
+#define STRUCTURED_PART_COMPACT_DECOMP_H
+
+#include "blocks.h"
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace structured_part {
+
+// Compact representation of a decomposition.  For each MeshBlock, the cut coordinates of
+// a tensor-product grid are stored in each direction, along with one rank per grid cell.
+// Sub-blocks that are not exactly one grid cell (ex. the remainder blocks created by
+// recursivelySplitBlock and the blocks created by the final split) are stored as exceptions.
+//
+// The blocks of each MeshBlock are identified by a slot index: slots
+// [0, getNumCells(meshblock_idx)) are the grid cells (some of which may be empty, because
+// they are covered by exceptions), and the following getNumExceptions(meshblock_idx) slots
+// are the exceptions.
+class CompactDecomposition
+{
+  public:
+    using RankType  = uint32_t;
+    using CoordType = uint32_t;
+    static constexpr RankType NoRank = std::numeric_limits<RankType>::max();
+
+    CompactDecomposition(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks,
+                         const std::vector<std::vector<SplitBlock>>& blocks_on_procs);
+
+    UInt getNumProcs() const { return m_nprocs; }
+
+    UInt getNumMeshBlocks() const { return m_encodings.size(); }
+
+    // returns the total number of SplitBlocks
+    UInt getNumBlocks() const { return m_num_blocks; }
+
+    const std::shared_ptr<MeshBlock>& getMeshBlock(UInt meshblock_idx) const { return m_encodings[meshblock_idx].meshblock; }
+
+    const std::vector<CoordType>& getCuts(UInt meshblock_idx, UInt dir) const { return m_encodings[meshblock_idx].cuts[dir]; }
+
+    UInt getNumCells(UInt meshblock_idx) const { return m_encodings[meshblock_idx].cell_ranks.size(); }
+
+    UInt getNumExceptions(UInt meshblock_idx) const { return m_encodings[meshblock_idx].exceptions.size(); }
+
+    UInt getNumSlots(UInt meshblock_idx) const { return getNumCells(meshblock_idx) + getNumExceptions(meshblock_idx); }
+
+    // returns false if the slot is a grid cell that is not a SplitBlock
+    bool hasBlock(UInt meshblock_idx, UInt slot) const { return getRank(meshblock_idx, slot) != NoRank; }
+
+    RankType getRank(UInt meshblock_idx, UInt slot) const;
+
+    SplitBlock getBlock(UInt meshblock_idx, UInt slot) const;
+
+    // returns the rank that owns the given element of the MeshBlock
+    RankType getOwner(UInt meshblock_idx, const std::array<UInt, 3>& element) const;
+
+    // calls func(rank, block) for every block, ordered by MeshBlock and then slot
+    void forEachBlock(const std::function<void(UInt rank, const SplitBlock& block)>& func) const;
+
+    // returns the decomposition in the form returned by partitionMesh
+    std::vector<std::vector<SplitBlock>> expand() const;
+
+    // returns the approximate number of bytes used by this object
+    UInt getMemoryUsage() const;
+
+    // writes a text representation that can be read back with read()
+    void write(std::ostream& os) const;
+
+    // reads a decomposition written by write().  New MeshBlocks are created for it
+    static CompactDecomposition read(std::istream& is);
+
+  private:
+    CompactDecomposition() = default;
+
+    struct Exception
+    {
+      std::array<CoordType, 3> element_counts;
+      std::array<CoordType, 3> mesh_offsets;
+      RankType rank;
+    };
+
+    struct BlockEncoding
+    {
+      std::shared_ptr<MeshBlock> meshblock;
+      std::array<std::vector<CoordType>, 3> cuts;  // includes 0 and the number of elements
+      std::vector<RankType> cell_ranks;            // k varies fastest
+      std::vector<Exception> exceptions;
+    };
+
+    void encodeMeshBlock(BlockEncoding& encoding, const std::vector<std::pair<RankType, const SplitBlock*>>& blocks);
+
+    std::array<UInt, 3> getCellCounts(const BlockEncoding& encoding) const;
+
+    UInt m_nprocs = 0;
+    UInt m_num_blocks = 0;
+    std::vector<BlockEncoding> m_encodings;
+};
+
+// returns the approximate number of bytes used by a decomposition in the form returned
+// by partitionMesh, not counting the MeshBlocks
+UInt computeMemoryUsage(const std::vector<std::vector<SplitBlock>>& blocks_on_procs);
+
+}
+
+#endif
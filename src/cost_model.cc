@@ -0,0 +1,29 @@
+#include "cost_model.h"
+
+namespace structured_part {
+
+UInt computeSurfaceArea(const SplitBlock& block)
+{
+  UInt num_elements = prod(block.element_counts);
+  UInt area = 0;
+  for (UInt d=0; d < getDimension(block.meshblock->element_counts); ++d)
+    area += 2 * (num_elements / block.element_counts[d]);
+
+  return area;
+}
+
+double computeBlockCost(const SplitBlock& block, const CostModel& cost_model)
+{
+  return block.weight + cost_model.per_block + cost_model.per_face_area * computeSurfaceArea(block);
+}
+
+double computeTotalCost(const std::vector<SplitBlock>& blocks, const CostModel& cost_model)
+{
+  double cost = 0.0;
+  for (const SplitBlock& block : blocks)
+    cost += computeBlockCost(block, cost_model);
+
+  return cost;
+}
+
+}
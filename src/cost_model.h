@@ -0,0 +1,30 @@
+#ifndef STRUCTURED_PART_COST_MODEL_H
+#define STRUCTURED_PART_COST_MODEL_H
+
+#include "blocks.h"
+#include <vector>
+
+namespace structured_part {
+
+// Modeled runtime cost of a block: its weight, plus a fixed overhead for each block (kernel
+// launches, boundary condition setup, messages) and an overhead proportional to its surface
+// area (halo exchange).  The default model is the weight alone
+struct CostModel
+{
+  double per_block = 0.0;
+  double per_face_area = 0.0;
+
+  bool isWeightOnly() const { return per_block == 0 && per_face_area == 0; }
+};
+
+// returns the number of element faces on the boundary of the block.  For blocks of 2D MeshBlocks
+// (see getDimension()), the faces normal to the k direction are not counted
+UInt computeSurfaceArea(const SplitBlock& block);
+
+double computeBlockCost(const SplitBlock& block, const CostModel& cost_model);
+
+double computeTotalCost(const std::vector<SplitBlock>& blocks, const CostModel& cost_model);
+
+}
+
+#endif
@@ -1,19 +1,263 @@
 #include "final_split.h"
 #include "assign_blocks_to_procs.h"
 #include "pre_split.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
 
 namespace structured_part {
 
-std::pair<UInt, double> computeMostOverWeightProc(const std::vector<std::vector<SplitBlock>>& blocks_on_procs)
+const char* getName(PartitionStatus status)
+{
+  switch (status)
+  {
+    case PartitionStatus::Balanced:          return "balanced";
+    case PartitionStatus::BudgetExhausted:   return "budget exhausted";
+    case PartitionStatus::NoSplittableBlock: return "no splittable block";
+    case PartitionStatus::NoImprovement:     return "no improvement";
+    case PartitionStatus::Unbalanced:        return "unbalanced";
+    default:
+      throw std::runtime_error("unhandled PartitionStatus");
+  }
+}
+
+const char* getName(PartitionEngine engine)
+{
+  switch (engine)
+  {
+    case PartitionEngine::SplitAndAssign:     return "split and assign";
+    case PartitionEngine::RecursiveBisection: return "recursive bisection";
+    default:
+      throw std::runtime_error("unhandled PartitionEngine");
+  }
+}
+
+namespace {
+
+// weights for WeightMode::Floating
+class FloatingWeights
 {
+  public:
+    using WeightType = double;
+
+    FloatingWeights(double avg_weight_per_proc, double load_balance_factor) :
+      m_avg_weight_per_proc(avg_weight_per_proc),
+      m_load_balance_factor(load_balance_factor)
+    {}
+
+    double getWeight(const SplitBlock& block) const { return block.weight; }
+
+    bool isBalanced(double max_weight_per_proc) const
+    {
+      return max_weight_per_proc <= m_avg_weight_per_proc * (1 + m_load_balance_factor);
+    }
+
+    double getImbalance(double max_weight_per_proc) const { return max_weight_per_proc / m_avg_weight_per_proc - 1; }
+
+    // returns the weight a proc can have over the average and still be balanced
+    double getBalanceSlack() const { return m_avg_weight_per_proc * m_load_balance_factor; }
+
+    // returns the fraction of block_weight that would have to move off the proc to make it average
+    double getExcessFraction(double max_weight_per_proc, double block_weight) const
+    {
+      return (max_weight_per_proc - m_avg_weight_per_proc) / block_weight;
+    }
+
+    std::vector<std::vector<SplitBlock>> assignBlocksToProcs(const std::vector<SplitBlock>& split_blocks, UInt nprocs,
+                                                             bool allow_non_adjacent_siblings) const
+    {
+      if (!allow_non_adjacent_siblings)
+        return structured_part::assignBlocksToProcs(split_blocks, nprocs);
+
+      std::vector<double> weights;
+      weights.reserve(split_blocks.size());
+      for (const SplitBlock& block : split_blocks)
+        weights.push_back(block.weight);
+
+      return structured_part::assignBlocksToProcs(split_blocks, weights, nprocs, true);
+    }
+
+    // the total weight does not change when blocks are split
+    void update(const std::vector<std::vector<SplitBlock>>& /*blocks_on_procs*/) {}
+
+  private:
+    double m_avg_weight_per_proc;
+    double m_load_balance_factor;
+};
+
+// weights for WeightMode::Integer.  Comparisons against the average weight are done by
+// multiplying through by nprocs, and the load balance factor is rounded to a fixed number
+// of bits once, so the balance check is exact
+class IntegerWeights
+{
+  public:
+    using WeightType = IntWeight;
+
+    IntegerWeights(const std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt nprocs, double load_balance_factor, UInt element_cost_scale) :
+      m_nprocs(nprocs),
+      m_element_cost_scale(element_cost_scale),
+      m_total_weight(0),
+      m_balance_numerator(std::llround((1 + load_balance_factor) * BalanceDenominator))
+    {
+      for (const std::vector<SplitBlock>& blocks : blocks_on_procs)
+        for (const SplitBlock& block : blocks)
+          m_total_weight += getWeight(block);
+    }
+
+    IntWeight getWeight(const SplitBlock& block) const { return computeIntegerWeight(block, m_element_cost_scale); }
+
+    bool isBalanced(IntWeight max_weight_per_proc) const
+    {
+      return WideInt(max_weight_per_proc) * m_nprocs * BalanceDenominator <= WideInt(m_total_weight) * m_balance_numerator;
+    }
+
+    double getImbalance(IntWeight max_weight_per_proc) const
+    {
+      return double(WideInt(max_weight_per_proc) * m_nprocs) / double(m_total_weight) - 1;
+    }
+
+    double getBalanceSlack() const
+    {
+      return double(m_total_weight) / m_nprocs * (double(m_balance_numerator) / BalanceDenominator - 1);
+    }
+
+    double getExcessFraction(IntWeight max_weight_per_proc, IntWeight block_weight) const
+    {
+      WideInt scaled_max_weight = WideInt(max_weight_per_proc) * m_nprocs;
+      WideInt excess = scaled_max_weight > m_total_weight ? scaled_max_weight - m_total_weight : 0;
+      return double(excess) / double(WideInt(block_weight) * m_nprocs);
+    }
+
+    std::vector<std::vector<SplitBlock>> assignBlocksToProcs(const std::vector<SplitBlock>& split_blocks, UInt nprocs,
+                                                             bool allow_non_adjacent_siblings) const
+    {
+      std::vector<IntWeight> weights;
+      weights.reserve(split_blocks.size());
+      for (const SplitBlock& block : split_blocks)
+        weights.push_back(getWeight(block));
+
+      return structured_part::assignBlocksToProcs(split_blocks, weights, nprocs, allow_non_adjacent_siblings);
+    }
+
+    void update(const std::vector<std::vector<SplitBlock>>& /*blocks_on_procs*/) {}
+
+  private:
+    using WideInt = unsigned __int128;
+    static constexpr IntWeight BalanceDenominator = IntWeight(1) << 20;
+
+    UInt m_nprocs;
+    UInt m_element_cost_scale;
+    IntWeight m_total_weight;
+    IntWeight m_balance_numerator;
+};
+
+// modeled costs (see CostModel).  Unlike the weight, the total cost increases every time a block is
+// split, so the average cost per proc is recomputed after every split
+class CostModelWeights
+{
+  public:
+    using WeightType = double;
+
+    CostModelWeights(const std::vector<std::vector<SplitBlock>>& blocks_on_procs, double load_balance_factor, const CostModel& cost_model) :
+      m_load_balance_factor(load_balance_factor),
+      m_cost_model(cost_model)
+    {
+      update(blocks_on_procs);
+    }
+
+    double getWeight(const SplitBlock& block) const { return computeBlockCost(block, m_cost_model); }
+
+    bool isBalanced(double max_cost_per_proc) const
+    {
+      return max_cost_per_proc <= m_avg_cost_per_proc * (1 + m_load_balance_factor);
+    }
+
+    double getImbalance(double max_cost_per_proc) const { return max_cost_per_proc / m_avg_cost_per_proc - 1; }
+
+    double getBalanceSlack() const { return m_avg_cost_per_proc * m_load_balance_factor; }
+
+    double getExcessFraction(double max_cost_per_proc, double block_cost) const
+    {
+      return (max_cost_per_proc - m_avg_cost_per_proc) / block_cost;
+    }
+
+    std::vector<std::vector<SplitBlock>> assignBlocksToProcs(const std::vector<SplitBlock>& split_blocks, UInt nprocs,
+                                                             bool allow_non_adjacent_siblings) const
+    {
+      std::vector<double> costs;
+      costs.reserve(split_blocks.size());
+      for (const SplitBlock& block : split_blocks)
+        costs.push_back(getWeight(block));
+
+      return structured_part::assignBlocksToProcs(split_blocks, costs, nprocs, allow_non_adjacent_siblings);
+    }
+
+    void update(const std::vector<std::vector<SplitBlock>>& blocks_on_procs)
+    {
+      double total_cost = 0.0;
+      for (const std::vector<SplitBlock>& blocks : blocks_on_procs)
+        total_cost += computeTotalCost(blocks, m_cost_model);
+
+      m_avg_cost_per_proc = total_cost / blocks_on_procs.size();
+    }
+
+  private:
+    double m_load_balance_factor;
+    CostModel m_cost_model;
+    double m_avg_cost_per_proc = 0.0;
+};
+
+// see PartitionOptions::max_memory_per_rank
+class MemoryLimit
+{
+  public:
+    explicit MemoryLimit(const PartitionOptions& options) :
+      m_memory_model(options.memory_model),
+      m_max_memory_per_rank(options.max_memory_per_rank)
+    {}
+
+    double getMemory(const SplitBlock& block) const { return computeBlockMemory(block, m_memory_model); }
+
+    // returns the proc with the most memory and how much it exceeds the limit by (zero if it does not)
+    std::pair<UInt, double> computeMostOverMemoryProc(const std::vector<std::vector<SplitBlock>>& blocks_on_procs) const
+    {
+      if (m_max_memory_per_rank == std::numeric_limits<double>::infinity())
+        return {0, 0.0};
+
+      UInt max_proc = 0;
+      double max_memory = 0.0;
+      for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
+      {
+        double memory = computeTotalMemory(blocks_on_procs[proc], m_memory_model);
+        if (memory > max_memory)
+        {
+          max_memory = memory;
+          max_proc = proc;
+        }
+      }
+
+      return {max_proc, std::max(max_memory - m_max_memory_per_rank, 0.0)};
+    }
+
+  private:
+    MemoryModel m_memory_model;
+    double m_max_memory_per_rank;
+};
+
+template <typename Weights>
+std::pair<UInt, typename Weights::WeightType> computeMostOverWeightProc(const std::vector<std::vector<SplitBlock>>& blocks_on_procs,
+                                                                       const Weights& weights)
+{
+  using WeightType = typename Weights::WeightType;
   UInt most_overweight_proc = 0;
-  double max_weight_per_proc = 0.0;
+  WeightType max_weight_per_proc = 0;
   for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
   {
-    double weight_on_proc = 0.0;
+    WeightType weight_on_proc = 0;
     for (const SplitBlock& split_block : blocks_on_procs[proc])
     {
-      weight_on_proc += split_block.weight;
+      weight_on_proc += weights.getWeight(split_block);
     }
 
     if (weight_on_proc > max_weight_per_proc)
@@ -26,27 +270,44 @@ std::pair<UInt, double> computeMostOverWeightProc(const std::vector<std::vector<
   return std::make_pair(most_overweight_proc, max_weight_per_proc);
 }
 
-SplitBlock* findLargestBlock(std::vector<SplitBlock>& blocks, const std::map<std::shared_ptr<MeshBlock>, UInt>& block_split_counts, UInt max_splits_per_block)
+// returns the largest block that can be split, or nullptr if there is none
+template <typename Weights>
+SplitBlock* findLargestSplittableBlock(std::vector<SplitBlock>& blocks, const std::map<std::shared_ptr<MeshBlock>, UInt>& block_split_counts,
+                                       UInt max_splits_per_block, const Weights& weights)
 {
-  if (blocks.size() == 0)
-    throw std::runtime_error("found zero sized vector");
-
-
   UInt max_block = -1;
-  double max_weight = 0.0;
+  typename Weights::WeightType max_weight = 0;
   for (UInt i=0; i < blocks.size(); ++i)
   {
-    if (blocks[i].weight > max_weight && block_split_counts.at(blocks[i].meshblock) < max_splits_per_block)
+    auto weight = weights.getWeight(blocks[i]);
+    bool can_split = prod(blocks[i].element_counts) > 1;
+    if (weight > max_weight && can_split && block_split_counts.at(blocks[i].meshblock) < max_splits_per_block)
     {
       max_block = i;
-      max_weight = blocks[i].weight;
+      max_weight = weight;
     }
   }
 
-  if (max_block == UInt(-1))
+  return max_block == UInt(-1) ? nullptr : &(blocks[max_block]);
+}
+
+}
+
+std::pair<UInt, double> computeMostOverWeightProc(const std::vector<std::vector<SplitBlock>>& blocks_on_procs)
+{
+  return computeMostOverWeightProc(blocks_on_procs, FloatingWeights(0, 0));
+}
+
+SplitBlock* findLargestBlock(std::vector<SplitBlock>& blocks, const std::map<std::shared_ptr<MeshBlock>, UInt>& block_split_counts, UInt max_splits_per_block)
+{
+  if (blocks.size() == 0)
+    throw std::runtime_error("found zero sized vector");
+
+  SplitBlock* largest_block = findLargestSplittableBlock(blocks, block_split_counts, max_splits_per_block, FloatingWeights(0, 0));
+  if (!largest_block)
     throw std::runtime_error("could not find a block to split");
 
-  return &(blocks[max_block]);
+  return largest_block;
 }
 
 std::vector<SplitBlock> flattenSplitBlocks(std::vector<std::vector<SplitBlock>> blocks_on_procs)
@@ -63,56 +324,263 @@ std::vector<SplitBlock> flattenSplitBlocks(std::vector<std::vector<SplitBlock>>
   return split_blocks;
 }
 
+namespace {
 
-void splitUntilLoadBalanced(std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt nprocs, double avg_weight_per_proc, double load_balance_factor)
+template <typename Weights>
+PartitionResult splitUntilLoadBalanced(std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt nprocs,
+                                       const PartitionOptions& options, Weights& weights)
 {
-  std::cout << "splitting until load balanced, avg weight per proc = " << avg_weight_per_proc << std::endl;
+  using Clock = std::chrono::steady_clock;
+  auto start_time = Clock::now();
+  auto getElapsedSeconds = [&]()
+  {
+    return std::chrono::duration<double>(Clock::now() - start_time).count();
+  };
 
   // avoid spitting into too small pieces
   // The value is a little bit arbitrary
   constexpr double max_split_fraction = 0.8;
 
+  // with one sub-block of each MeshBlock per proc, a MeshBlock cannot be split into more than nprocs sub-blocks
+  UInt max_splits_per_block = options.allow_non_adjacent_siblings ? std::numeric_limits<UInt>::max() : nprocs;
+
   //TODO: its unfortunate we have to use a map for this
   std::map<std::shared_ptr<MeshBlock>, UInt> block_split_counts;
   for (UInt i=0; i < blocks_on_procs.size(); ++i)
     for (const SplitBlock& split_block : blocks_on_procs[i])
       block_split_counts[split_block.meshblock]++;
 
-  auto [most_overweight_proc, max_weight_per_proc ] = computeMostOverWeightProc(blocks_on_procs);
-  while (max_weight_per_proc > avg_weight_per_proc * (1 + load_balance_factor))
+  PartitionResult result;
+  auto [most_overweight_proc, max_weight_per_proc ] = computeMostOverWeightProc(blocks_on_procs, weights);
+  MemoryLimit memory_limit(options);
+  auto [most_over_memory_proc, memory_excess] = memory_limit.computeMostOverMemoryProc(blocks_on_procs);
+  auto best_max_weight_per_proc = max_weight_per_proc;
+  double best_memory_excess = memory_excess;
+  std::vector<std::vector<SplitBlock>> best_blocks_on_procs;
+  bool current_is_best = true;
+  UInt num_stalled_iterations = 0;
+  while (!weights.isBalanced(max_weight_per_proc) || memory_excess > 0)
   {
+    if (result.num_iterations >= options.max_iterations || getElapsedSeconds() >= options.time_limit)
+    {
+      result.status = PartitionStatus::BudgetExhausted;
+      break;
+    }
+
+    if (num_stalled_iterations >= options.max_stalled_iterations)
+    {
+      result.status = PartitionStatus::NoImprovement;
+      break;
+    }
+
+    // the memory limit is a hard constraint, so fix it first
+    UInt split_proc = memory_excess > 0 ? most_over_memory_proc : most_overweight_proc;
+
     // this is a trick to avoid having to find the largest_block in the flattened array
-    SplitBlock* largest_block = findLargestBlock(blocks_on_procs[most_overweight_proc], block_split_counts, nprocs);
+    SplitBlock* largest_block = findLargestSplittableBlock(blocks_on_procs[split_proc], block_split_counts, max_splits_per_block, weights);
+    if (!largest_block)
+    {
+      result.status = PartitionStatus::NoSplittableBlock;
+      break;
+    }
 
-    double split_fraction = (max_weight_per_proc - avg_weight_per_proc) / largest_block->weight;
+    double split_fraction = memory_excess > 0 ? memory_excess / memory_limit.getMemory(*largest_block) :
+                                                weights.getExcessFraction(max_weight_per_proc, weights.getWeight(*largest_block));
     split_fraction = std::min(split_fraction, max_split_fraction);
 
-    auto [left_block, right_block] = splitBlock(*largest_block, split_fraction);
-    *largest_block = left_block;
+    SplitBlock unsplit_block = *largest_block;
+    std::vector<std::pair<SplitBlock, SplitBlock>> splits;
+    std::vector<UInt> split_areas;
+    if (options.cut_selection == CutSelection::BestCut)
+    {
+      // the longest-axis cut is tried first and counted as having no area, so it wins ties and
+      // another cut is only picked if it balances the decomposition better
+      splits.push_back(splitBlock(unsplit_block, split_fraction));
+      split_areas.push_back(0);
+      for (const BlockCut& cut : getCandidateCuts(unsplit_block, split_fraction, options.max_cut_aspect_ratio))
+      {
+        splits.push_back(splitBlock(unsplit_block, static_cast<SplitDirection>(cut.dir), cut.nelem));
+        split_areas.push_back(cut.area);
+      }
+    } else
+    {
+      splits.push_back(splitBlock(unsplit_block, split_fraction));
+      split_areas.push_back(0);
+    }
+
+    // reassign the blocks for each candidate cut.  If any cut balances the decomposition, the
+    // balanced cut with the smallest area is picked.  Otherwise the cut that leaves the fewest
+    // procs over the limit is picked, then the one with the smallest maximum weight per proc, and
+    // the area only breaks ties
+    std::vector<std::vector<std::vector<SplitBlock>>> split_blocks_on_procs(splits.size());
+    std::vector<std::pair<UInt, double>> split_excess(splits.size(), {std::numeric_limits<UInt>::max(), std::numeric_limits<double>::infinity()});
+    for (UInt i=0; i < splits.size(); ++i)
+    {
+      *largest_block = splits[i].first;
+      std::vector<SplitBlock> split_blocks = flattenSplitBlocks(blocks_on_procs);
+      split_blocks.push_back(splits[i].second);
+
+      try
+      {
+        split_blocks_on_procs[i] = weights.assignBlocksToProcs(split_blocks, nprocs, options.allow_non_adjacent_siblings);
+      } catch (const std::runtime_error&)
+      {
+        // with allow_non_adjacent_siblings, every proc may have a sub-block adjacent to one of the
+        // new blocks
+        continue;
+      }
+
+      split_excess[i] = {0, 0};
+      if (splits.size() > 1)
+      {
+        weights.update(split_blocks_on_procs[i]);
+        typename Weights::WeightType max_weight = 0;
+        for (const std::vector<SplitBlock>& blocks : split_blocks_on_procs[i])
+        {
+          typename Weights::WeightType weight_on_proc = 0;
+          for (const SplitBlock& block : blocks)
+            weight_on_proc += weights.getWeight(block);
+
+          split_excess[i].first += weights.isBalanced(weight_on_proc) ? 0 : 1;
+          max_weight = std::max(max_weight, weight_on_proc);
+        }
+        split_excess[i].second = double(max_weight);
+      }
+    }
+
+    // the tolerance only absorbs rounding error, so balance is never traded for area
+    auto min_excess = *std::min_element(split_excess.begin(), split_excess.end());
+    double max_weight_tolerance = 1e-12 * min_excess.second;
+    UInt best_split = splits.size();
+    bool found_split = min_excess.first != std::numeric_limits<UInt>::max();
+    for (UInt i=0; i < splits.size() && found_split; ++i)
+    {
+      bool is_candidate = split_excess[i].first == min_excess.first &&
+                          (min_excess.first == 0 || split_excess[i].second <= min_excess.second + max_weight_tolerance);
+      if (is_candidate && (best_split == splits.size() || split_areas[i] < split_areas[best_split]))
+        best_split = i;
+    }
+
+    *largest_block = unsplit_block;
+    if (!found_split)
+    {
+      result.status = PartitionStatus::NoSplittableBlock;
+      break;
+    }
+
+    // splitting can make the decomposition worse (temporarily), so keep the best one.  The
+    // current decomposition is replaced by a new one, so it can be moved rather than copied
+    if (current_is_best)
+      best_blocks_on_procs = std::move(blocks_on_procs);
+    blocks_on_procs = std::move(split_blocks_on_procs[best_split]);
+    block_split_counts[unsplit_block.meshblock]++;
+    weights.update(blocks_on_procs);
+    std::tie(most_overweight_proc, max_weight_per_proc) = computeMostOverWeightProc(blocks_on_procs, weights); 
+    std::tie(most_over_memory_proc, memory_excess) = memory_limit.computeMostOverMemoryProc(blocks_on_procs);
+    result.num_iterations++;
 
-    std::vector<SplitBlock> split_blocks = flattenSplitBlocks(blocks_on_procs);
-    split_blocks.push_back(right_block);
+    current_is_best = memory_excess < best_memory_excess ||
+                      (memory_excess == best_memory_excess && max_weight_per_proc < best_max_weight_per_proc);
+    if (current_is_best)
+    {
+      best_max_weight_per_proc = max_weight_per_proc;
+      best_memory_excess = memory_excess;
+    }
 
-    block_split_counts[right_block.meshblock]++;
+    num_stalled_iterations = current_is_best ? 0 : num_stalled_iterations + 1;
+  }
 
-    blocks_on_procs = assignBlocksToProcs(split_blocks, nprocs);
-    std::tie(most_overweight_proc, max_weight_per_proc) = computeMostOverWeightProc(blocks_on_procs); 
+  if (!current_is_best)
+  {
+    blocks_on_procs = std::move(best_blocks_on_procs);
+    weights.update(blocks_on_procs);
   }
+
+  result.imbalance = weights.getImbalance(best_max_weight_per_proc);
+  return result;
 }
 
+}
 
-std::vector<std::vector<SplitBlock>> finalSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor)
+void splitUntilLoadBalanced(std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt nprocs, double avg_weight_per_proc, double load_balance_factor)
+{
+  PartitionResult result = splitUntilLoadBalanced(blocks_on_procs, nprocs, avg_weight_per_proc, load_balance_factor, PartitionOptions());
+  if (result.status == PartitionStatus::NoSplittableBlock)
+    throw std::runtime_error("could not find a block to split");
+}
+
+PartitionResult splitUntilLoadBalanced(std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt nprocs, double avg_weight_per_proc,
+                                       double load_balance_factor, const PartitionOptions& options)
+{
+  if (options.weight_mode == WeightMode::Integer)
+  {
+    if (!options.cost_model.isWeightOnly())
+      throw std::runtime_error("cost models are not supported with integer weights");
+
+    IntegerWeights weights(blocks_on_procs, nprocs, load_balance_factor, options.element_cost_scale);
+    return splitUntilLoadBalanced(blocks_on_procs, nprocs, options, weights);
+  } else if (!options.cost_model.isWeightOnly())
+  {
+    CostModelWeights weights(blocks_on_procs, load_balance_factor, options.cost_model);
+    return splitUntilLoadBalanced(blocks_on_procs, nprocs, options, weights);
+  } else
+  {
+    FloatingWeights weights(avg_weight_per_proc, load_balance_factor);
+    return splitUntilLoadBalanced(blocks_on_procs, nprocs, options, weights);
+  }
+}
+
+
+namespace {
+
+// the cache is optional
+PartitionResult finalSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                           const PartitionOptions& options, SplitCache* cache)
 {
   double avg_weight_per_proc = 0.0;
   for (const auto& mesh_block : mesh_blocks)
     avg_weight_per_proc += mesh_block->weight;
   avg_weight_per_proc /= nprocs;
 
-  
-  std::vector<std::vector<SplitBlock>> blocks_on_procs = preSplit(mesh_blocks, nprocs);
-  splitUntilLoadBalanced(blocks_on_procs, nprocs, avg_weight_per_proc, load_balance_factor);
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = cache ? preSplit(mesh_blocks, nprocs, options, *cache) :
+                                                                 preSplit(mesh_blocks, nprocs, options);
+  PartitionResult result = splitUntilLoadBalanced(blocks_on_procs, nprocs, avg_weight_per_proc, load_balance_factor, options);
+  result.blocks_on_procs = std::move(blocks_on_procs);
+
+  return result;
+}
+
+std::vector<std::vector<SplitBlock>> getBalancedBlocks(PartitionResult&& result)
+{
+  if (result.status == PartitionStatus::NoSplittableBlock)
+    throw std::runtime_error("could not find a block to split");
+
+  return std::move(result.blocks_on_procs);
+}
+
+}
+
+std::vector<std::vector<SplitBlock>> finalSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor)
+{
+  return getBalancedBlocks(finalSplit(mesh_blocks, nprocs, load_balance_factor, PartitionOptions(), nullptr));
+}
 
-  return blocks_on_procs;
+std::vector<std::vector<SplitBlock>> finalSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                                                SplitCache& cache)
+{
+  return getBalancedBlocks(finalSplit(mesh_blocks, nprocs, load_balance_factor, PartitionOptions(), &cache));
 }
 
-}
\ No newline at end of file
+PartitionResult finalSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                           const PartitionOptions& options)
+{
+  return finalSplit(mesh_blocks, nprocs, load_balance_factor, options, nullptr);
+}
+
+PartitionResult finalSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                           const PartitionOptions& options, SplitCache& cache)
+{
+  return finalSplit(mesh_blocks, nprocs, load_balance_factor, options, &cache);
+}
+
+}
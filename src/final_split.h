@@ -3,6 +3,8 @@
 
 #include "ProjectDefs.h"
 #include "blocks.h"
+#include "partition_options.h"
+#include "pre_split.h"
 #include <map>
 
 namespace structured_part {
@@ -13,8 +15,25 @@ SplitBlock* findLargestBlock(std::vector<SplitBlock>& blocks, const std::map<std
 
 void splitUntilLoadBalanced(std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt nprocs, double avg_weight_per_proc, double load_balance_factor);
 
+// same as above, but stops when the budget in options runs out or there is no block to split rather
+// than throwing.  blocks_on_procs is set to the best decomposition seen
+PartitionResult splitUntilLoadBalanced(std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt nprocs, double avg_weight_per_proc,
+                                       double load_balance_factor, const PartitionOptions& options);
+
 std::vector<std::vector<SplitBlock>> finalSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor);
 
+// same as above, but reuses the MeshBlock splits in cache
+std::vector<std::vector<SplitBlock>> finalSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                                                SplitCache& cache);
+
+// same as above, but returns the best decomposition found within the budget in options
+PartitionResult finalSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                           const PartitionOptions& options);
+
+// same as above, but reuses the MeshBlock splits in cache
+PartitionResult finalSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                           const PartitionOptions& options, SplitCache& cache);
+
 
 }
 
@@ -0,0 +1,167 @@
+#include "block_file.h"
+#include "compact_decomp.h"
+#include "final_split.h"
+#include "pre_split.h"
+#include "rank_graph.h"
+#include "statistics.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+using namespace structured_part;
+
+namespace {
+
+void printUsage(std::ostream& os, const char* exe_name)
+{
+  os << "Usage: " << exe_name << " block_file nprocs [load_balance_factor] [-o output_file] [-g graph_file]\n"
+     << "       [-m ghost_width bytes_per_cell bytes_per_block] [-M max_memory_per_rank]\n"
+     << "\n"
+     << "  block_file: text file with one line per mesh block: block_id nx ny nz [weight]\n"
+     << "  nprocs: number of processes to partition the mesh for\n"
+     << "  load_balance_factor: maximum allowed imbalance, default 0.1\n"
+     << "  output_file: file to write the decomposition to, in the format of\n"
+     << "               CompactDecomposition::write()\n"
+     << "  graph_file: file to write the communication graph between processes to, in the\n"
+     << "              METIS graph format\n"
+     << "  ghost_width, bytes_per_cell, bytes_per_block: estimate the memory of each process,\n"
+     << "              see MemoryModel\n"
+     << "  max_memory_per_rank: keep splitting blocks until no process needs more memory\n"
+     << "              than this (requires -m)\n";
+}
+
+class PhaseTimer
+{
+  public:
+    void start(const std::string& name)
+    {
+      m_name = name;
+      m_start = std::chrono::steady_clock::now();
+    }
+
+    void stop()
+    {
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+      m_phases.emplace_back(m_name, elapsed.count());
+    }
+
+    void print(std::ostream& os) const
+    {
+      double total = 0.0;
+      os << "phase timings (s):\n";
+      for (auto& [name, time] : m_phases)
+      {
+        os << "  " << name << ": " << time << "\n";
+        total += time;
+      }
+      os << "  total: " << total << std::endl;
+    }
+
+  private:
+    std::string m_name;
+    std::chrono::steady_clock::time_point m_start;
+    std::vector<std::pair<std::string, double>> m_phases;
+};
+
+}
+
+int main(int argc, char* argv[])
+{
+  std::vector<std::string> positional_args;
+  std::string output_fname, graph_fname;
+  bool estimate_memory = false;
+  PartitionOptions options;
+  for (int i=1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      output_fname = argv[++i];
+    else if (std::strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+      graph_fname = argv[++i];
+    else if (std::strcmp(argv[i], "-m") == 0 && i + 3 < argc)
+    {
+      estimate_memory = true;
+      options.memory_model.ghost_width = std::stoul(argv[++i]);
+      options.memory_model.bytes_per_cell = std::stod(argv[++i]);
+      options.memory_model.bytes_per_block = std::stod(argv[++i]);
+    } else if (std::strcmp(argv[i], "-M") == 0 && i + 1 < argc)
+      options.max_memory_per_rank = std::stod(argv[++i]);
+    else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0)
+    {
+      printUsage(std::cout, argv[0]);
+      return 0;
+    } else
+      positional_args.push_back(argv[i]);
+  }
+
+  if (positional_args.size() < 2 || positional_args.size() > 3 ||
+      (!estimate_memory && options.max_memory_per_rank != std::numeric_limits<double>::infinity()))
+  {
+    printUsage(std::cerr, argv[0]);
+    return 1;
+  }
+
+  try
+  {
+    UInt nprocs = std::stoul(positional_args[1]);
+    double load_balance_factor = positional_args.size() > 2 ? std::stod(positional_args[2]) : 0.1;
+    if (nprocs == 0)
+      throw std::runtime_error("nprocs must be greater than zero");
+
+    PhaseTimer timer;
+    timer.start("read block file");
+    std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = readBlockFile(positional_args[0]);
+    timer.stop();
+    std::cout << "read " << mesh_blocks.size() << " mesh blocks" << std::endl;
+
+    timer.start("pre split");
+    double avg_weight_per_proc = computeAvgWorkPerProc(mesh_blocks, nprocs);
+    std::vector<std::vector<SplitBlock>> blocks_on_procs = preSplit(mesh_blocks, nprocs);
+    timer.stop();
+
+    timer.start("final split");
+    PartitionResult result = splitUntilLoadBalanced(blocks_on_procs, nprocs, avg_weight_per_proc, load_balance_factor, options);
+    timer.stop();
+    if (result.status != PartitionStatus::Balanced)
+      std::cout << "warning: stopped before the decomposition was balanced (" << getName(result.status) << ")" << std::endl;
+
+    timer.start("statistics");
+    DecompStats stats = computeDecompStats(blocks_on_procs);
+    timer.stop();
+
+    if (output_fname.size() > 0)
+    {
+      timer.start("write decomposition");
+      std::ofstream output_file(output_fname);
+      if (!output_file)
+        throw std::runtime_error("could not open file " + output_fname);
+
+      CompactDecomposition(mesh_blocks, blocks_on_procs).write(output_file);
+      timer.stop();
+    }
+
+    if (graph_fname.size() > 0)
+    {
+      timer.start("write rank graph");
+      writeMetisGraph(graph_fname, computeRankGraph(blocks_on_procs));
+      timer.stop();
+    }
+
+    std::cout << stats << std::endl;
+    if (estimate_memory)
+    {
+      MemoryStats memory_stats = computeMemoryStats(blocks_on_procs, options.memory_model);
+      std::cout << memory_stats << std::endl;
+      printHistogram(std::cout, memory_stats);
+    }
+    timer.print(std::cout);
+  } catch (std::exception& e)
+  {
+    std::cerr << "error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,41 @@
+#include "memory_model.h"
+
+namespace structured_part {
+
+UInt computeAllocatedCells(const SplitBlock& block, UInt ghost_width, bool ghosts_on_mesh_boundary)
+{
+  const std::array<UInt, 3>& meshblock_counts = block.meshblock->element_counts;
+  UInt dim = getDimension(meshblock_counts);
+  UInt num_cells = 1;
+  for (UInt d=0; d < 3; ++d)
+  {
+    UInt count = block.element_counts[d];
+    if (d < dim)
+    {
+      bool lower_has_ghosts = ghosts_on_mesh_boundary || block.mesh_offsets[d] > 0;
+      bool upper_has_ghosts = ghosts_on_mesh_boundary || block.mesh_offsets[d] + block.element_counts[d] < meshblock_counts[d];
+      count += ghost_width * (UInt(lower_has_ghosts) + UInt(upper_has_ghosts));
+    }
+
+    num_cells *= count;
+  }
+
+  return num_cells;
+}
+
+double computeBlockMemory(const SplitBlock& block, const MemoryModel& memory_model)
+{
+  UInt num_cells = computeAllocatedCells(block, memory_model.ghost_width, memory_model.ghosts_on_mesh_boundary);
+  return memory_model.bytes_per_cell * num_cells + memory_model.bytes_per_block;
+}
+
+double computeTotalMemory(const std::vector<SplitBlock>& blocks, const MemoryModel& memory_model)
+{
+  double memory = 0.0;
+  for (const SplitBlock& block : blocks)
+    memory += computeBlockMemory(block, memory_model);
+
+  return memory;
+}
+
+}
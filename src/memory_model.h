@@ -0,0 +1,32 @@
+#ifndef STRUCTURED_PART_MEMORY_MODEL_H
+#define STRUCTURED_PART_MEMORY_MODEL_H
+
+#include "blocks.h"
+#include <vector>
+
+namespace structured_part {
+
+// Estimated memory of a block: bytes_per_cell for each allocated cell plus a fixed overhead for each
+// block (metadata, message buffers).  The allocated cells are the elements of the block plus
+// ghost_width layers of ghost cells on each face that is interior to the MeshBlock.  Faces on the
+// boundary of the MeshBlock only get ghost cells if ghosts_on_mesh_boundary is true
+struct MemoryModel
+{
+  UInt ghost_width = 0;
+  double bytes_per_cell = 1.0;
+  double bytes_per_block = 0.0;
+  bool ghosts_on_mesh_boundary = false;
+};
+
+// returns the number of cells in the block including the ghost cells, ie. the size of the array
+// that stores it (so the ghost cells in the edges and corners are included).  For 2D MeshBlocks
+// (see getDimension()), there are no ghost cells in the k direction
+UInt computeAllocatedCells(const SplitBlock& block, UInt ghost_width, bool ghosts_on_mesh_boundary=false);
+
+double computeBlockMemory(const SplitBlock& block, const MemoryModel& memory_model);
+
+double computeTotalMemory(const std::vector<SplitBlock>& blocks, const MemoryModel& memory_model);
+
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef STRUCTURED_PART_PARTITION_OPTIONS_H
+#define STRUCTURED_PART_PARTITION_OPTIONS_H
+
+#include "blocks.h"
+#include "cost_model.h"
+#include "memory_model.h"
+#include <limits>
+#include <vector>
+
+namespace structured_part {
+
+enum class WeightMode
+{
+  Floating,  // compare SplitBlock::weight
+  Integer    // compare computeIntegerWeight() with exact integer arithmetic, so the result does not
+             // depend on the compiler or floating point flags
+};
+
+// how recursivelySplitBlock handles a number of sub-blocks that no grid matches exactly
+enum class RemainderStrategy
+{
+  NestedSlabs,    // cut a slab off the block for the remainder and split it again.  For prime or
+                  // awkward numbers of sub-blocks this can produce thin slabs
+  SpreadOverRows  // split the block into slabs along its longest direction, with some slabs split
+                  // into one more sub-block than the others (and made thicker in proportion), and
+                  // split each slab the same way in the remaining directions
+};
+
+// how the final split cuts a block
+enum class CutSelection
+{
+  LongestAxis,  // cut along the longest axis, rounding the target fraction to an element count
+  BestCut       // try the cuts from getCandidateCuts() in every direction, see PartitionOptions::cut_selection
+};
+
+enum class PartitionEngine
+{
+  SplitAndAssign,     // pre-split the MeshBlocks, assign the sub-blocks to procs and split until load balanced
+  RecursiveBisection  // recursively bisect the set of blocks by weight, see recursive_bisection.h
+};
+
+const char* getName(PartitionEngine engine);
+
+// optional settings for partitionMesh.  The defaults give the same result as the
+// partitionMesh overloads that do not take options
+struct PartitionOptions
+{
+  // maximum number of blocks the final split creates
+  UInt max_iterations = std::numeric_limits<UInt>::max();
+
+  // maximum time (in seconds) spent in the final split.  Checked once per iteration
+  double time_limit = std::numeric_limits<double>::infinity();
+
+  WeightMode weight_mode = WeightMode::Floating;
+
+  // for WeightMode::Integer, the cost of an element of a MeshBlock is
+  // round(element_cost_scale * weight / number of elements).  The default is exact for
+  // the default MeshBlock weights (one per element)
+  UInt element_cost_scale = 1;
+
+  // cost that assignment and final splitting balance.  The load balance factor then applies
+  // to the modeled cost, and the final split only keeps a split if it reduces the maximum
+  // cost per rank.  Only supported with WeightMode::Floating
+  CostModel cost_model;
+
+  // by default a proc holds at most one sub-block of each MeshBlock.  If true, a proc may hold
+  // several sub-blocks of the same MeshBlock as long as no two of them share a face, so each
+  // sub-block is still a separate array with its own halo.  This allows fewer cuts to reach
+  // the load balance factor for meshes with a few large blocks
+  bool allow_non_adjacent_siblings = false;
+
+  // stop if this many splits in a row do not reduce the maximum weight (or cost) per rank.
+  // Useful with a cost model, for which the load balance factor may not be achievable
+  UInt max_stalled_iterations = std::numeric_limits<UInt>::max();
+
+  // used by the pre-split of the SplitAndAssign engine
+  RemainderStrategy remainder_strategy = RemainderStrategy::NestedSlabs;
+
+  // used by the final split of the SplitAndAssign engine.  With CutSelection::BestCut, the blocks
+  // are reassigned for the longest-axis cut and for each cut from getCandidateCuts.  The balanced
+  // cut with the smallest area is kept if there is one, otherwise the cut that leaves the fewest
+  // procs over the limit, then the smallest maximum weight per proc.  The longest-axis cut wins
+  // ties.  The candidates create blocks with an aspect ratio of at most max_cut_aspect_ratio if
+  // possible.  This costs one assignment per candidate cut per iteration, about 5 times the time
+  // of LongestAxis.  It saves a few percent of the iterations, but the cut surface is about the
+  // same, and individual meshes vary in both directions
+  CutSelection cut_selection = CutSelection::LongestAxis;
+  double max_cut_aspect_ratio = 4.0;
+
+  // if finite, the final split also splits blocks on any proc whose estimated memory (see
+  // MemoryModel) exceeds max_memory_per_rank, and the decomposition is only balanced if no proc
+  // does.  The blocks are still assigned to procs by weight (or cost)
+  MemoryModel memory_model;
+  double max_memory_per_rank = std::numeric_limits<double>::infinity();
+
+  // the RecursiveBisection engine does not use max_iterations, time_limit, max_stalled_iterations
+  // or allow_non_adjacent_siblings, and only supports WeightMode::Floating without a cost model
+  // or memory limit
+  PartitionEngine engine = PartitionEngine::SplitAndAssign;
+
+  // number of threads the RecursiveBisection engine runs independent subtrees on
+  // (0 means one per hardware thread)
+  UInt num_threads = 1;
+};
+
+enum class PartitionStatus
+{
+  Balanced,         // the load balance factor (and memory limit) was achieved
+  BudgetExhausted,  // max_iterations or time_limit was reached first
+  NoSplittableBlock, // no block on the most loaded rank could be split further
+  NoImprovement,     // max_stalled_iterations was reached
+  Unbalanced         // an engine without a final split (recursive bisection, repartitionMesh)
+                     // did not achieve the load balance factor
+};
+
+const char* getName(PartitionStatus status);
+
+struct PartitionResult
+{
+  // the best decomposition seen, ie. the one with the smallest maximum weight per rank
+  std::vector<std::vector<SplitBlock>> blocks_on_procs;
+  PartitionStatus status = PartitionStatus::Balanced;
+  double imbalance = 0.0;  // max weight (or cost) per rank / average weight (or cost) per rank - 1
+  UInt num_iterations = 0;
+};
+
+}
+
+#endif
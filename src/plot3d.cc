@@ -0,0 +1,265 @@
+#include "plot3d.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace structured_part {
+
+namespace {
+
+class MappedFile
+{
+  public:
+    explicit MappedFile(const std::string& fname)
+    {
+      int fd = open(fname.c_str(), O_RDONLY);
+      if (fd < 0)
+        throw std::runtime_error("could not open file " + fname);
+
+      struct stat file_stat;
+      if (fstat(fd, &file_stat) != 0)
+      {
+        close(fd);
+        throw std::runtime_error("could not stat file " + fname);
+      }
+
+      m_size = file_stat.st_size;
+      if (m_size > 0)
+      {
+        m_data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m_data == MAP_FAILED)
+        {
+          close(fd);
+          throw std::runtime_error("could not mmap file " + fname);
+        }
+      }
+      close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+      if (m_data)
+        munmap(m_data, m_size);
+    }
+
+    UInt size() const { return m_size; }
+
+    const unsigned char* data() const { return static_cast<const unsigned char*>(m_data); }
+
+  private:
+    void* m_data = nullptr;
+    UInt m_size = 0;
+};
+
+class HeaderReader
+{
+  public:
+    HeaderReader(const MappedFile& file, bool swap_bytes) :
+      m_file(file),
+      m_swap_bytes(swap_bytes)
+    {}
+
+    UInt getNumInts() const { return m_file.size() / sizeof(int32_t); }
+
+    // returns the idx-th 4 byte integer in the file
+    int64_t getInt(UInt idx) const
+    {
+      if (idx >= getNumInts())
+        throw std::runtime_error("unexpected end of Plot3D file");
+
+      uint32_t val;
+      std::memcpy(&val, m_file.data() + idx*sizeof(uint32_t), sizeof(uint32_t));
+      if (m_swap_bytes)
+        val = ((val & 0xff) << 24) | ((val & 0xff00) << 8) | ((val & 0xff0000) >> 8) | (val >> 24);
+
+      return static_cast<int32_t>(val);
+    }
+
+    UInt getFileSize() const { return m_file.size(); }
+
+  private:
+    const MappedFile& m_file;
+    bool m_swap_bytes;
+};
+
+struct Plot3DHeader
+{
+  std::vector<std::array<UInt, 3>> block_dims;
+  UInt header_size = 0;  // in bytes
+};
+
+bool isPlausible(const HeaderReader& reader, const Plot3DHeader& header)
+{
+  // every block must have at least single precision x, y, z coordinates
+  UInt min_size = header.header_size;
+  for (const auto& dims : header.block_dims)
+  {
+    for (UInt dim : dims)
+      if (dim == 0)
+        return false;
+
+    min_size += 3 * prod(dims) * sizeof(float);
+  }
+
+  return header.block_dims.size() > 0 && min_size <= reader.getFileSize();
+}
+
+// returns true if the file holds exactly the header and x, y, z coordinates (and optionally iblank)
+// for each point in single or double precision.  Only applies to files without record markers
+bool hasExactSize(const HeaderReader& reader, const Plot3DHeader& header)
+{
+  UInt num_points = 0;
+  for (const auto& dims : header.block_dims)
+    num_points += prod(dims);
+
+  for (UInt bytes_per_point : {3*sizeof(float), 3*sizeof(float) + sizeof(int32_t), 3*sizeof(double), 3*sizeof(double) + sizeof(int32_t)})
+    if (header.header_size + num_points * bytes_per_point == reader.getFileSize())
+      return true;
+
+  return false;
+}
+
+// tries to parse the header assuming Fortran record markers.  Returns false if the
+// file does not have them
+bool parseWithRecordMarkers(const HeaderReader& reader, Plot3DHeader& header)
+{
+  if (reader.getNumInts() < 3)
+    return false;
+
+  UInt idx = 0;
+  int64_t first_record_size = reader.getInt(idx);
+  UInt num_blocks = 1;
+  if (first_record_size == 4 && reader.getInt(2) == 4)
+  {
+    // multi-block
+    num_blocks = reader.getInt(1);
+    idx = 3;
+    if (num_blocks == 0 || reader.getNumInts() < idx + 1)
+      return false;
+  }
+
+  int64_t dims_record_size = reader.getInt(idx);
+  UInt dim = 0;
+  if (dims_record_size == int64_t(3*sizeof(int32_t)*num_blocks))
+    dim = 3;
+  else if (dims_record_size == int64_t(2*sizeof(int32_t)*num_blocks))
+    dim = 2;
+  else
+    return false;
+
+  if (reader.getNumInts() < idx + dim*num_blocks + 2 || reader.getInt(idx + dim*num_blocks + 1) != dims_record_size)
+    return false;
+
+  idx++;
+  header.block_dims.resize(num_blocks);
+  for (UInt i=0; i < num_blocks; ++i)
+    for (UInt d=0; d < 3; ++d)
+    {
+      int64_t val = d < dim ? reader.getInt(idx++) : 1;
+      header.block_dims[i][d] = val > 0 ? val : 0;
+    }
+
+  // each coordinate record also has markers
+  header.header_size = (idx + 1)*sizeof(int32_t) + 2*sizeof(int32_t)*num_blocks;
+
+  return true;
+}
+
+bool parseWithoutRecordMarkers(const HeaderReader& reader, Plot3DHeader& header)
+{
+  if (reader.getNumInts() == 0)
+    return false;
+
+  int64_t num_blocks = reader.getInt(0);
+  if (num_blocks <= 0 || UInt(num_blocks) > (reader.getNumInts() - 1) / 3)
+    return false;
+
+  header.block_dims.resize(num_blocks);
+  for (int64_t i=0; i < num_blocks; ++i)
+    for (UInt d=0; d < 3; ++d)
+    {
+      int64_t val = reader.getInt(1 + 3*i + d);
+      header.block_dims[i][d] = val > 0 ? val : 0;
+    }
+  header.header_size = (1 + 3*num_blocks)*sizeof(int32_t);
+
+  return true;
+}
+
+// a single-block file without record markers has no block count, the header is just ni nj nk
+bool parseSingleBlockWithoutRecordMarkers(const HeaderReader& reader, Plot3DHeader& header)
+{
+  if (reader.getNumInts() < 3)
+    return false;
+
+  header.block_dims.resize(1);
+  for (UInt d=0; d < 3; ++d)
+  {
+    int64_t val = reader.getInt(d);
+    header.block_dims[0][d] = val > 0 ? val : 0;
+  }
+  header.header_size = 3*sizeof(int32_t);
+
+  return true;
+}
+
+}
+
+std::vector<std::shared_ptr<MeshBlock>> readPlot3DBlocks(const std::string& fname)
+{
+  MappedFile file(fname);
+
+  Plot3DHeader header;
+  bool found_header = false;
+  for (bool swap_bytes : {false, true})
+  {
+    HeaderReader reader(file, swap_bytes);
+    header = Plot3DHeader();
+    if (parseWithRecordMarkers(reader, header) && isPlausible(reader, header))
+    {
+      found_header = true;
+      break;
+    }
+  }
+
+  // without record markers, the first integer of a multi-block file is the number of blocks and
+  // the first integer of a single-block file is ni, so prefer the interpretation that matches the
+  // size of the file exactly, and then the one that is plausible
+  for (bool exact_size : {true, false})
+    for (bool swap_bytes : {false, true})
+      for (auto parse : {parseWithoutRecordMarkers, parseSingleBlockWithoutRecordMarkers})
+      {
+        if (found_header)
+          break;
+
+        HeaderReader reader(file, swap_bytes);
+        header = Plot3DHeader();
+        found_header = parse(reader, header) && isPlausible(reader, header) && (!exact_size || hasExactSize(reader, header));
+      }
+
+  if (!found_header)
+    throw std::runtime_error("could not read Plot3D header from file " + fname);
+
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks;
+  for (UInt i=0; i < header.block_dims.size(); ++i)
+  {
+    std::array<UInt, 3> element_counts;
+    for (UInt d=0; d < 3; ++d)
+      element_counts[d] = std::max(header.block_dims[i][d], UInt(2)) - 1;
+
+    mesh_blocks.push_back(std::make_shared<MeshBlock>(i, element_counts[0], element_counts[1], element_counts[2]));
+  }
+
+  return mesh_blocks;
+}
+
+}
@@ -0,0 +1,24 @@
+#ifndef STRUCTURED_PART_PLOT3D_H
+#define STRUCTURED_PART_PLOT3D_H
+
+#include "blocks.h"
+#include <string>
+#include <vector>
+
+namespace structured_part {
+
+// reads the block dimensions from the header of a binary Plot3D grid file, without
+// reading any of the coordinate data.  The file is memory mapped, so only the pages
+// containing the header are read from disk, and the cost is O(number of blocks)
+// regardless of the size of the file.
+// Multi-block and single-block files, with and without Fortran record markers, in either
+// byte order, are supported.  2D files (ni, nj only) are supported if they have record
+// markers (otherwise they cannot be distinguished from 3D files).  Without record markers,
+// single-block and multi-block files are told apart by which header matches the size of the file.
+// The MeshBlocks have block_id equal to the index of the block in the file, and
+// max(n - 1, 1) elements in each direction, where n is the number of points
+std::vector<std::shared_ptr<MeshBlock>> readPlot3DBlocks(const std::string& fname);
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include <limits>
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include "assign_blocks_to_procs.h"
 
 
@@ -42,12 +43,21 @@ UInt getMostUnderWeightBlock(const std::vector<std::shared_ptr<MeshBlock>>& mesh
 }
 
 UInt getMostOverWeightBlock(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, const std::vector<UInt>& num_splits_per_block, UInt max_splits_per_block)
+{
+  std::vector<double> weights;
+  for (const auto& mesh_block : mesh_blocks)
+    weights.push_back(mesh_block->weight);
+
+  return getMostOverWeightBlock(weights, num_splits_per_block, max_splits_per_block);
+}
+
+UInt getMostOverWeightBlock(const std::vector<double>& weights, const std::vector<UInt>& num_splits_per_block, UInt max_splits_per_block)
 {
   UInt block_most_under_weight = -1;
   double max_weight = std::numeric_limits<double>::min();
-  for (UInt i=0; i < mesh_blocks.size(); ++i)
+  for (UInt i=0; i < weights.size(); ++i)
   {
-    double weight_per_split_block = mesh_blocks[i]->weight / num_splits_per_block[i];
+    double weight_per_split_block = weights[i] / num_splits_per_block[i];
 
     if (weight_per_split_block > max_weight && num_splits_per_block[i] < max_splits_per_block)
     {
@@ -65,20 +75,24 @@ UInt getMostOverWeightBlock(const std::vector<std::shared_ptr<MeshBlock>>& mesh_
 }
 
 // computes a decomposition of roughly equally sized block with number of blocks <= num_split_blocks
+template <UInt Dim>
 std::array<UInt, 3> computeEvenlyDivisibleBlockGrid(const SplitBlock& input_block, UInt num_split_blocks)
 {
+  assert(Dim == 3 || input_block.element_counts[2] == 1);
+
   std::array<UInt, 3> num_blocks_per_direction = {1, 1, 1};
-  std::array<double, 3> num_elems_per_directions = {static_cast<double>(input_block.element_counts[0]),
-                                                    static_cast<double>(input_block.element_counts[1]),
-                                                    static_cast<double>(input_block.element_counts[2])};
+  std::array<double, Dim> num_elems_per_directions;
+  for (UInt d=0; d < Dim; ++d)
+    num_elems_per_directions[d] = input_block.element_counts[d];
 
-  while (num_blocks_per_direction[0] * num_blocks_per_direction[1] * num_blocks_per_direction[2] < num_split_blocks)
+  UInt num_blocks = 1;
+  while (num_blocks < num_split_blocks)
   {
     UInt max_direction = 0;
     double max_elements_per_direction = num_elems_per_directions[max_direction];
-    for (UInt i=1; i < 3; ++i)
+    for (UInt i=1; i < Dim; ++i)
     {
-      // this also enforces the condition that num_blocks_per_direction[i] < num_elems_per_direction[i] in the original block
+      // this also enforces the condition that num_blocks_per_direction[i] < num_elem_per_direction[i] in the original block
       // (if there exists a solution)
       if (num_elems_per_directions[i] > max_elements_per_direction)
       {
@@ -87,65 +101,83 @@ std::array<UInt, 3> computeEvenlyDivisibleBlockGrid(const SplitBlock& input_bloc
       }
     }
 
-    std::array<UInt, 3> new_num_blocks_per_direction = num_blocks_per_direction;
-    new_num_blocks_per_direction[max_direction]++;
-    UInt new_num_blocks = new_num_blocks_per_direction[0] * new_num_blocks_per_direction[1] * new_num_blocks_per_direction[2];
+    UInt new_num_blocks = (num_blocks / num_blocks_per_direction[max_direction]) * (num_blocks_per_direction[max_direction] + 1);
     if (new_num_blocks > num_split_blocks)
     {
       break;
     }
 
-    num_blocks_per_direction = new_num_blocks_per_direction;
+    num_blocks_per_direction[max_direction]++;
+    num_blocks = new_num_blocks;
     num_elems_per_directions[max_direction] = double(input_block.element_counts[max_direction]) / num_blocks_per_direction[max_direction];
   }
 
   return num_blocks_per_direction;
 }
 
+namespace {
+
+// number of elements in sub-block idx when num_elements are divided into num_blocks pieces.  The
+// first (num_elements % num_blocks) pieces get one extra element
+UInt getNumElements(UInt num_elements, UInt num_blocks, UInt idx)
+{
+  return num_elements / num_blocks + (idx < num_elements % num_blocks ? 1 : 0);
+}
+
+// offset of sub-block idx from the start of the range, see getNumElements
+UInt getElementOffset(UInt num_elements, UInt num_blocks, UInt idx)
+{
+  return idx * (num_elements / num_blocks) + std::min(idx, num_elements % num_blocks);
+}
+
+}
+
+template <UInt Dim>
 std::array<std::vector<UInt>, 3> computeNumElementsPerBlock(const SplitBlock& input_block, 
                                                             const std::array<UInt, 3>& num_blocks_per_direction)
 {
   std::array<std::vector<UInt>, 3> num_elem_per_block;
-  for (UInt d=0; d < 3; ++d)
+  for (UInt d=0; d < Dim; ++d)
   {
-    UInt max_num_elements_per_direction = input_block.element_counts[d] / num_blocks_per_direction[d];
-    UInt remainder = input_block.element_counts[d] - (num_blocks_per_direction[d] - 1)*max_num_elements_per_direction;
-    for (UInt i=0; i < num_blocks_per_direction[d] - 1; ++i)
-      num_elem_per_block[d].push_back(max_num_elements_per_direction);
-
-    num_elem_per_block[d].push_back(remainder);
-
-    UInt idx = 0;
-    while (num_elem_per_block[d][num_blocks_per_direction[d]-1] > max_num_elements_per_direction)
-    {
-      num_elem_per_block[d][idx]++;
-      num_elem_per_block[d][num_blocks_per_direction[d]-1]--;
-      idx = (idx + 1) % (num_blocks_per_direction[d] - 1);
-    }
+    num_elem_per_block[d].resize(num_blocks_per_direction[d]);
+    for (UInt i=0; i < num_blocks_per_direction[d]; ++i)
+      num_elem_per_block[d][i] = getNumElements(input_block.element_counts[d], num_blocks_per_direction[d], i);
   }
 
+  if constexpr (Dim == 2)
+    num_elem_per_block[2] = {input_block.element_counts[2]};
+
   return num_elem_per_block;  
 }
 
+template <UInt Dim>
 std::vector<SplitBlock> createSplitBlocks(const SplitBlock& input_block, 
                                           const std::array<std::vector<UInt>, 3>& num_elem_per_block)
 {
   std::array<UInt, 3> num_blocks_per_direction = {num_elem_per_block[0].size(), num_elem_per_block[1].size(), num_elem_per_block[2].size()};
 
   std::vector<SplitBlock> new_blocks;
+  new_blocks.reserve(prod(num_blocks_per_direction));
   std::array<UInt, 3> block_offset = input_block.mesh_offsets;
   for (UInt i=0; i < num_blocks_per_direction[0]; ++i)
   {
     block_offset[1] = input_block.mesh_offsets[1];
     for (UInt j=0; j < num_blocks_per_direction[1]; ++j)
     {
-      block_offset[2] = input_block.mesh_offsets[2];
-      for (UInt k=0; k < num_blocks_per_direction[2]; ++k)
+      if constexpr (Dim == 2)
       {
-        std::array<UInt, 3> elems_in_block = {num_elem_per_block[0][i], num_elem_per_block[1][j], num_elem_per_block[2][k]};
+        std::array<UInt, 3> elems_in_block = {num_elem_per_block[0][i], num_elem_per_block[1][j], input_block.element_counts[2]};
         new_blocks.emplace_back(input_block.meshblock, elems_in_block, block_offset);
-
-        block_offset[2] += num_elem_per_block[2][k];
+      } else
+      {
+        block_offset[2] = input_block.mesh_offsets[2];
+        for (UInt k=0; k < num_blocks_per_direction[2]; ++k)
+        {
+          std::array<UInt, 3> elems_in_block = {num_elem_per_block[0][i], num_elem_per_block[1][j], num_elem_per_block[2][k]};
+          new_blocks.emplace_back(input_block.meshblock, elems_in_block, block_offset);
+
+          block_offset[2] += num_elem_per_block[2][k];
+        }
       }
       block_offset[1] += num_elem_per_block[1][j];
     }
@@ -156,46 +188,196 @@ std::vector<SplitBlock> createSplitBlocks(const SplitBlock& input_block,
   return new_blocks;
 }
 
+template std::array<UInt, 3> computeEvenlyDivisibleBlockGrid<2>(const SplitBlock& input_block, UInt num_split_blocks);
+template std::array<UInt, 3> computeEvenlyDivisibleBlockGrid<3>(const SplitBlock& input_block, UInt num_split_blocks);
+template std::array<std::vector<UInt>, 3> computeNumElementsPerBlock<2>(const SplitBlock& input_block, const std::array<UInt, 3>& num_blocks_per_direction);
+template std::array<std::vector<UInt>, 3> computeNumElementsPerBlock<3>(const SplitBlock& input_block, const std::array<UInt, 3>& num_blocks_per_direction);
+template std::vector<SplitBlock> createSplitBlocks<2>(const SplitBlock& input_block, const std::array<std::vector<UInt>, 3>& num_elem_per_block);
+template std::vector<SplitBlock> createSplitBlocks<3>(const SplitBlock& input_block, const std::array<std::vector<UInt>, 3>& num_elem_per_block);
+
+namespace {
+
+// appends the blocks of the given grid over input_block to split_blocks.  Same as
+// createSplitBlocks(input_block, computeNumElementsPerBlock(input_block, num_blocks_per_direction))
+// but without the temporary vectors
+template <UInt Dim>
+void appendGridBlocks(const SplitBlock& input_block, const std::array<UInt, 3>& num_blocks_per_direction,
+                      std::vector<SplitBlock>& split_blocks)
+{
+  const std::array<UInt, 3>& counts = input_block.element_counts;
+  const std::array<UInt, 3>& grid = num_blocks_per_direction;
+  for (UInt i=0; i < grid[0]; ++i)
+    for (UInt j=0; j < grid[1]; ++j)
+    {
+      std::array<UInt, 3> elems_in_block = {getNumElements(counts[0], grid[0], i), getNumElements(counts[1], grid[1], j), counts[2]};
+      std::array<UInt, 3> block_offset = {input_block.mesh_offsets[0] + getElementOffset(counts[0], grid[0], i),
+                                          input_block.mesh_offsets[1] + getElementOffset(counts[1], grid[1], j),
+                                          input_block.mesh_offsets[2]};
+      if constexpr (Dim == 2)
+      {
+        split_blocks.emplace_back(input_block.meshblock, elems_in_block, block_offset);
+      } else
+      {
+        for (UInt k=0; k < grid[2]; ++k)
+        {
+          elems_in_block[2] = getNumElements(counts[2], grid[2], k);
+          block_offset[2]   = input_block.mesh_offsets[2] + getElementOffset(counts[2], grid[2], k);
+          split_blocks.emplace_back(input_block.meshblock, elems_in_block, block_offset);
+        }
+      }
+    }
+}
 
-// split the block into num_split_blocks, using a recursive approach to deal with non-evenly divisible
-// number of blocks
-std::vector<SplitBlock> recursivelySplitBlock(const SplitBlock& input_block, UInt num_split_blocks)
+// split the block into num_split_blocks.  If the number of blocks is not evenly divisible, the block is
+// split into a main block that gets a grid and a remainder block that is split again.  The blocks still
+// to be split are kept on a stack (main block on top) so the output order is the same as splitting
+// the main block and then the remainder block recursively.
+// Sub-blocks of a 2D block are also 2D, so Dim is fixed for the whole split
+template <UInt Dim>
+void recursivelySplitBlock(const SplitBlock& input_block, UInt num_split_blocks, std::vector<SplitBlock>& split_blocks)
 {
-  std::array<UInt, 3> num_blocks_per_direction = computeEvenlyDivisibleBlockGrid(input_block, num_split_blocks);
-  UInt num_blocks_in_grid = prod(num_blocks_per_direction);
-  UInt num_remainder_blocks = num_split_blocks - num_blocks_in_grid;
+  // most blocks fit a grid exactly and do not need the stack
+  std::array<UInt, 3> input_grid = computeEvenlyDivisibleBlockGrid<Dim>(input_block, num_split_blocks);
+  if (prod(input_grid) == num_split_blocks)
+  {
+    appendGridBlocks<Dim>(input_block, input_grid, split_blocks);
+    return;
+  }
 
-  if (num_remainder_blocks > 0)
+  std::vector<std::pair<SplitBlock, UInt>> pending;
+  pending.emplace_back(input_block, num_split_blocks);
+  while (pending.size() > 0)
   {
-    double weight_fraction = double(num_blocks_in_grid) / num_split_blocks;
-    auto [main_block, remainder_block] = splitBlock(input_block, weight_fraction);
+    auto [block, num_blocks] = std::move(pending.back());
+    pending.pop_back();
 
-    num_blocks_per_direction = computeEvenlyDivisibleBlockGrid(main_block, num_blocks_in_grid);
+    std::array<UInt, 3> num_blocks_per_direction = computeEvenlyDivisibleBlockGrid<Dim>(block, num_blocks);
+    UInt num_blocks_in_grid = prod(num_blocks_per_direction);
+    UInt num_remainder_blocks = num_blocks - num_blocks_in_grid;
 
-    if (prod(num_blocks_per_direction) != num_blocks_in_grid)
-      throw std::runtime_error("dividing block changed number of blocks in grid");
+    if (num_remainder_blocks == 0)
+    {
+      appendGridBlocks<Dim>(block, num_blocks_per_direction, split_blocks);
+      continue;
+    }
 
-    std::array<std::vector<UInt>, 3> num_elem_per_block = computeNumElementsPerBlock(main_block, num_blocks_per_direction);
-    std::vector<SplitBlock> new_blocks = createSplitBlocks(main_block, num_elem_per_block);
+    double weight_fraction = double(num_blocks_in_grid) / num_blocks;
+    auto [main_block, remainder_block] = splitBlock(block, weight_fraction);
+    pending.emplace_back(remainder_block, num_remainder_blocks);
 
-    std::vector<SplitBlock> remainder_blocks;
-    if (num_remainder_blocks > 1)
+    num_blocks_per_direction = computeEvenlyDivisibleBlockGrid<Dim>(main_block, num_blocks_in_grid);
+    if (prod(num_blocks_per_direction) == num_blocks_in_grid)
     {
-      remainder_blocks = recursivelySplitBlock(remainder_block, num_remainder_blocks);
+      appendGridBlocks<Dim>(main_block, num_blocks_per_direction, split_blocks);
     } else
     {
-      remainder_blocks = {remainder_block};
+      // dividing the block changed the shape enough that the grid no longer fits
+      // (ex. 33 x 71 split into 4), so split the main block again as well
+      pending.emplace_back(main_block, num_blocks_in_grid);
+    }
+  }
+}
+
+
+// splits block into num_blocks sub-blocks in the directions that are true in free_dirs.  The block
+// is cut into slabs along the longest free direction, with the number of slabs chosen so the
+// sub-blocks are roughly cubes.  Each slab gets num_blocks / num_slabs sub-blocks, and the first
+// num_blocks % num_slabs slabs get one more, with the thickness of each slab proportional to its
+// number of sub-blocks.  Each slab is then split the same way in the remaining free directions
+template <UInt Dim>
+void appendJaggedBlocks(const SplitBlock& block, UInt num_blocks, std::array<bool, 3> free_dirs, std::vector<SplitBlock>& split_blocks)
+{
+  UInt dir = 3, num_free_dirs = 0;
+  double free_volume = 1;
+  for (UInt d=0; d < Dim; ++d)
+    if (free_dirs[d])
+    {
+      num_free_dirs++;
+      free_volume *= block.element_counts[d];
+      if (dir == 3 || block.element_counts[d] > block.element_counts[dir])
+        dir = d;
     }
 
-    for (const SplitBlock& split_block : remainder_blocks)
-      new_blocks.push_back(split_block);
+  UInt count = block.element_counts[dir];
+  UInt num_slabs = num_blocks;
+  if (num_free_dirs > 1)
+  {
+    double block_length = std::pow(free_volume / num_blocks, 1.0 / num_free_dirs);
+    num_slabs = std::max(UInt(std::round(count / block_length)), UInt(1));
+    num_slabs = std::min(num_slabs, num_blocks);
+  }
 
-    return new_blocks;
-  } else
+  if (num_slabs > count)
   {
-    std::array<std::vector<UInt>, 3> num_elem_per_block = computeNumElementsPerBlock(input_block, num_blocks_per_direction);
-    return createSplitBlocks(input_block, num_elem_per_block);
+    // there are too few elements for a sub-block in every slab, which only happens for very
+    // thin blocks
+    recursivelySplitBlock<Dim>(block, num_blocks, split_blocks);
+    return;
   }
+
+  free_dirs[dir] = false;
+  UInt slab_start = 0, num_blocks_before = 0;
+  for (UInt slab=0; slab < num_slabs; ++slab)
+  {
+    UInt num_blocks_in_slab = getNumElements(num_blocks, num_slabs, slab);
+    num_blocks_before += num_blocks_in_slab;
+
+    // leave at least one element for each of the remaining slabs
+    UInt slab_end = std::round(double(count) * num_blocks_before / num_blocks);
+    slab_end = std::max(slab_end, slab_start + 1);
+    slab_end = std::min(slab_end, count - (num_slabs - slab - 1));
+
+    std::array<UInt, 3> slab_counts = block.element_counts, slab_offsets = block.mesh_offsets;
+    slab_counts[dir]   = slab_end - slab_start;
+    slab_offsets[dir] += slab_start;
+    SplitBlock slab_block(block.meshblock, slab_counts, slab_offsets);
+
+    if (num_blocks_in_slab == 1)
+      split_blocks.push_back(slab_block);
+    else
+      appendJaggedBlocks<Dim>(slab_block, num_blocks_in_slab, free_dirs, split_blocks);
+
+    slab_start = slab_end;
+  }
+}
+
+// RemainderStrategy::SpreadOverRows: uses a grid if one matches num_blocks exactly, and a
+// jagged grid otherwise
+template <UInt Dim>
+void spreadRemainderOverRows(const SplitBlock& input_block, UInt num_blocks, std::vector<SplitBlock>& split_blocks)
+{
+  std::array<UInt, 3> num_blocks_per_direction = computeEvenlyDivisibleBlockGrid<Dim>(input_block, num_blocks);
+  if (prod(num_blocks_per_direction) == num_blocks)
+    appendGridBlocks<Dim>(input_block, num_blocks_per_direction, split_blocks);
+  else
+    appendJaggedBlocks<Dim>(input_block, num_blocks, {true, true, Dim == 3}, split_blocks);
+}
+
+}
+
+void recursivelySplitBlock(const SplitBlock& input_block, UInt num_split_blocks, std::vector<SplitBlock>& split_blocks,
+                           RemainderStrategy remainder_strategy)
+{
+  bool is_2d = getDimension(input_block.element_counts) == 2;
+  if (remainder_strategy == RemainderStrategy::SpreadOverRows)
+  {
+    if (is_2d)
+      spreadRemainderOverRows<2>(input_block, num_split_blocks, split_blocks);
+    else
+      spreadRemainderOverRows<3>(input_block, num_split_blocks, split_blocks);
+  } else if (is_2d)
+    recursivelySplitBlock<2>(input_block, num_split_blocks, split_blocks);
+  else
+    recursivelySplitBlock<3>(input_block, num_split_blocks, split_blocks);
+}
+
+std::vector<SplitBlock> recursivelySplitBlock(const SplitBlock& input_block, UInt num_split_blocks)
+{
+  std::vector<SplitBlock> split_blocks;
+  split_blocks.reserve(num_split_blocks);
+  recursivelySplitBlock(input_block, num_split_blocks, split_blocks);
+
+  return split_blocks;
 }
 
 std::vector<SplitBlock> recursivelySplitBlock(std::shared_ptr<MeshBlock> input_block, UInt num_split_blocks)
@@ -204,56 +386,262 @@ std::vector<SplitBlock> recursivelySplitBlock(std::shared_ptr<MeshBlock> input_b
 }
 
 
-std::vector<SplitBlock> splitBlocks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, const std::vector<UInt>& num_splits_per_block)
+std::vector<SplitBlock> SplitCache::recursivelySplitBlock(const std::shared_ptr<MeshBlock>& input_block, UInt num_split_blocks)
 {
   std::vector<SplitBlock> split_blocks;
-  for (UInt i=0; i < mesh_blocks.size(); ++i)
+  recursivelySplitBlock(input_block, num_split_blocks, split_blocks);
+
+  return split_blocks;
+}
+
+void SplitCache::recursivelySplitBlock(const std::shared_ptr<MeshBlock>& input_block, UInt num_split_blocks,
+                                       std::vector<SplitBlock>& split_blocks, RemainderStrategy remainder_strategy)
+{
+  Key key(input_block.get(), num_split_blocks, remainder_strategy);
   {
-    SplitBlock block(mesh_blocks[i]);
-    std::vector<SplitBlock> new_blocks = recursivelySplitBlock(block, num_splits_per_block[i]);
-    for (const auto& new_block : new_blocks)
-      split_blocks.push_back(new_block);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_split_blocks.find(key);
+    if (it != m_split_blocks.end())
+    {
+      split_blocks.insert(split_blocks.end(), it->second.begin(), it->second.end());
+      return;
+    }
   }
 
+  // two threads may compute the same split, but the result is the same
+  UInt start = split_blocks.size();
+  structured_part::recursivelySplitBlock(SplitBlock(input_block), num_split_blocks, split_blocks, remainder_strategy);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_split_blocks.emplace(key, std::vector<SplitBlock>(split_blocks.begin() + start, split_blocks.end()));
+}
+
+namespace {
+
+UInt computeTotalNumSplits(const std::vector<UInt>& num_splits_per_block)
+{
+  return std::accumulate(num_splits_per_block.begin(), num_splits_per_block.end(), UInt(0));
+}
+
+}
+
+std::vector<SplitBlock> splitBlocks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, const std::vector<UInt>& num_splits_per_block,
+                                    RemainderStrategy remainder_strategy)
+{
+  std::vector<SplitBlock> split_blocks;
+  split_blocks.reserve(computeTotalNumSplits(num_splits_per_block));
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+    recursivelySplitBlock(SplitBlock(mesh_blocks[i]), num_splits_per_block[i], split_blocks, remainder_strategy);
+
+  return split_blocks;
+}
+
+std::vector<SplitBlock> splitBlocks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, const std::vector<UInt>& num_splits_per_block,
+                                    SplitCache& cache, RemainderStrategy remainder_strategy)
+{
+  std::vector<SplitBlock> split_blocks;
+  split_blocks.reserve(computeTotalNumSplits(num_splits_per_block));
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+    cache.recursivelySplitBlock(mesh_blocks[i], num_splits_per_block[i], split_blocks, remainder_strategy);
+
   return split_blocks;
 }
 
 // returns a vector telling how many sub-blocks to split each block into
 std::vector<UInt> computeNumSubBlocks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs)
 {
+  std::vector<double> weights;
+  for (const auto& mesh_block : mesh_blocks)
+    weights.push_back(mesh_block->weight);
+
+  return computeNumSubBlocks(weights, nprocs);
+}
+
+namespace {
+
+// adds num_new_splits splits, one at a time, each to the block with the largest weight per split
+// (the lowest index on ties) that has fewer than max_splits_per_block splits.
+// This is the same as calling getMostOverWeightBlock for each split, but is O(num_new_splits log B)
+void addSplitsToHeaviestBlocks(const std::vector<double>& weights, std::vector<UInt>& num_splits_per_block,
+                               UInt num_new_splits, UInt max_splits_per_block)
+{
+  using WeightAndIdx = std::pair<double, UInt>;
+  auto isLighter = [](const WeightAndIdx& lhs, const WeightAndIdx& rhs)
+  {
+    return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second > rhs.second);
+  };
+
+  std::vector<WeightAndIdx> heap;
+  for (UInt i=0; i < weights.size(); ++i)
+    if (num_splits_per_block[i] < max_splits_per_block)
+      heap.emplace_back(weights[i] / num_splits_per_block[i], i);
+  std::make_heap(heap.begin(), heap.end(), isLighter);
+
+  for (UInt split=0; split < num_new_splits; ++split)
+  {
+    if (heap.size() == 0)
+      throw std::runtime_error("could not reduce the number of splits in any block");
 
-  double avg_weight_per_proc = computeAvgWorkPerProc(mesh_blocks, nprocs);
+    std::pop_heap(heap.begin(), heap.end(), isLighter);
+    UInt idx = heap.back().second;
+    heap.pop_back();
 
-  std::vector<UInt> num_splits_per_block(mesh_blocks.size(), 0);
+    num_splits_per_block[idx]++;
+    if (num_splits_per_block[idx] < max_splits_per_block)
+    {
+      heap.emplace_back(weights[idx] / num_splits_per_block[idx], idx);
+      std::push_heap(heap.begin(), heap.end(), isLighter);
+    }
+  }
+}
+
+}
+
+std::vector<UInt> computeNumSubBlocks(const std::vector<double>& weights, UInt nprocs)
+{
+  double avg_weight_per_proc = std::accumulate(weights.begin(), weights.end(), 0.0) / nprocs;
+
+  std::vector<UInt> num_splits_per_block(weights.size(), 0);
   UInt num_splits = 0;  // num splits is the number of sub-blocks to split 
                         // a given block into, not the number of cuts to make
 
-  for (UInt i=0; i < mesh_blocks.size(); ++i)
+  for (UInt i=0; i < weights.size(); ++i)
   {
-    num_splits_per_block[i] = std::max(std::ceil(mesh_blocks[i]->weight / avg_weight_per_proc), 1.0);
+    num_splits_per_block[i] = std::max(std::ceil(weights[i] / avg_weight_per_proc), 1.0);
     num_splits_per_block[i] = std::min(num_splits_per_block[i], nprocs);
     num_splits += num_splits_per_block[i];
   }
 
   // adjust splits so there are at least as many sub-blocks as procs
-  while (num_splits < nprocs)
+  if (num_splits < nprocs)
+    addSplitsToHeaviestBlocks(weights, num_splits_per_block, nprocs - num_splits, nprocs);
+
+  return num_splits_per_block;
+}
+
+std::vector<UInt> computeNumSubBlocks(const std::vector<IntWeight>& weights, UInt nprocs)
+{
+  using WideInt = unsigned __int128;
+  WideInt total_weight = std::accumulate(weights.begin(), weights.end(), WideInt(0));
+  if (total_weight == 0)
+    throw std::runtime_error("total weight must be greater than zero");
+
+  // the sum of ceil(weights[i] * nprocs / total_weight) is at least nprocs, so unlike the
+  // floating point version, no splits need to be added afterwards
+  std::vector<UInt> num_splits_per_block(weights.size());
+  for (UInt i=0; i < weights.size(); ++i)
   {
-    UInt block_most_under_weight = getMostOverWeightBlock(mesh_blocks, num_splits_per_block, nprocs);
-    num_splits_per_block[block_most_under_weight]++;
-    num_splits++;
+    WideInt num_splits = (WideInt(weights[i]) * nprocs + total_weight - 1) / total_weight;
+    num_splits_per_block[i] = std::min(std::max(num_splits, WideInt(1)), WideInt(nprocs));
   }
 
   return num_splits_per_block;
 }
 
+std::vector<UInt> computeNumSubBlocksMinMax(const std::vector<double>& weights, UInt nprocs, UInt num_sub_blocks)
+{
+  if (num_sub_blocks < weights.size())
+    throw std::runtime_error("number of sub-blocks must be at least the number of blocks");
+
+  if (num_sub_blocks > weights.size() * nprocs)
+    throw std::runtime_error("number of sub-blocks must be at most the number of blocks times the number of procs");
+
+  std::vector<UInt> num_splits_per_block(weights.size(), 1);
+  addSplitsToHeaviestBlocks(weights, num_splits_per_block, num_sub_blocks - weights.size(), nprocs);
+
+  return num_splits_per_block;
+}
+
+std::vector<UInt> computeNumSubBlocksMinMax(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, UInt num_sub_blocks)
+{
+  std::vector<double> weights;
+  for (const auto& mesh_block : mesh_blocks)
+    weights.push_back(mesh_block->weight);
+
+  return computeNumSubBlocksMinMax(weights, nprocs, num_sub_blocks);
+}
+
+
+namespace {
+
+// splits the MeshBlocks into the given number of sub-blocks each, with or without a SplitCache
+using SplitStep = std::function<std::vector<SplitBlock>(const std::vector<UInt>& num_splits_per_block, RemainderStrategy remainder_strategy)>;
+
+// a MeshBlock cannot be split into more sub-blocks than it has elements.  With fewer elements
+// than procs, some procs are left without a block
+std::vector<UInt> limitToNumElements(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, std::vector<UInt> num_splits_per_block)
+{
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+    num_splits_per_block[i] = std::min(num_splits_per_block[i], prod(mesh_blocks[i]->element_counts));
+
+  return num_splits_per_block;
+}
+
+std::vector<std::vector<SplitBlock>> preSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs,
+                                              const PartitionOptions& options, const SplitStep& split_step)
+{
+  if (options.weight_mode == WeightMode::Floating)
+  {
+    std::vector<UInt> num_splits_per_block = limitToNumElements(mesh_blocks, computeNumSubBlocks(mesh_blocks, nprocs));
+    std::vector<SplitBlock> split_blocks = split_step(num_splits_per_block, options.remainder_strategy);
+    if (options.cost_model.isWeightOnly() && !options.allow_non_adjacent_siblings)
+      return assignBlocksToProcs(split_blocks, nprocs);
+
+    std::vector<double> costs;
+    costs.reserve(split_blocks.size());
+    for (const SplitBlock& block : split_blocks)
+      costs.push_back(computeBlockCost(block, options.cost_model));
+
+    return assignBlocksToProcs(split_blocks, costs, nprocs, options.allow_non_adjacent_siblings);
+  }
+
+  std::vector<IntWeight> mesh_block_weights;
+  for (const auto& mesh_block : mesh_blocks)
+    mesh_block_weights.push_back(computeIntegerWeight(SplitBlock(mesh_block), options.element_cost_scale));
+
+  std::vector<UInt> num_splits_per_block = limitToNumElements(mesh_blocks, computeNumSubBlocks(mesh_block_weights, nprocs));
+  std::vector<SplitBlock> split_blocks = split_step(num_splits_per_block, options.remainder_strategy);
+
+  std::vector<IntWeight> weights;
+  weights.reserve(split_blocks.size());
+  for (const SplitBlock& block : split_blocks)
+    weights.push_back(computeIntegerWeight(block, options.element_cost_scale));
+
+  return assignBlocksToProcs(split_blocks, weights, nprocs, options.allow_non_adjacent_siblings);
+}
+
+}
 
 std::vector<std::vector<SplitBlock>> preSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs)
 {
-  std::vector<UInt> num_splits_per_block = computeNumSubBlocks(mesh_blocks, nprocs);
-  std::vector<SplitBlock> split_blocks = splitBlocks(mesh_blocks, num_splits_per_block);
-  auto blocks_on_procs = assignBlocksToProcs(split_blocks, nprocs);
+  return preSplit(mesh_blocks, nprocs, PartitionOptions());
+}
+
+std::vector<std::vector<SplitBlock>> preSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, SplitCache& cache)
+{
+  return preSplit(mesh_blocks, nprocs, PartitionOptions(), cache);
+}
+
+std::vector<std::vector<SplitBlock>> preSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs,
+                                              const PartitionOptions& options)
+{
+  auto split_step = [&](const std::vector<UInt>& num_splits_per_block, RemainderStrategy remainder_strategy)
+  {
+    return splitBlocks(mesh_blocks, num_splits_per_block, remainder_strategy);
+  };
+
+  return preSplit(mesh_blocks, nprocs, options, SplitStep(split_step));
+}
+
+std::vector<std::vector<SplitBlock>> preSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs,
+                                              const PartitionOptions& options, SplitCache& cache)
+{
+  auto split_step = [&](const std::vector<UInt>& num_splits_per_block, RemainderStrategy remainder_strategy)
+  {
+    return splitBlocks(mesh_blocks, num_splits_per_block, cache, remainder_strategy);
+  };
 
-  return blocks_on_procs;
+  return preSplit(mesh_blocks, nprocs, options, SplitStep(split_step));
 }
 
-}
\ No newline at end of file
+}
@@ -2,6 +2,10 @@
 #define STRUCTURED_PART_PRE_SPLIT_H
 
 #include "blocks.h"
+#include "partition_options.h"
+#include <map>
+#include <mutex>
+#include <tuple>
 #include <vector>
 
 namespace structured_part {
@@ -12,22 +16,71 @@ UInt getMostUnderWeightBlock(const std::vector<std::shared_ptr<MeshBlock>>& mesh
 
 UInt getMostOverWeightBlock(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, const std::vector<UInt>& num_splits_per_block, UInt max_splits_per_block);
 
+UInt getMostOverWeightBlock(const std::vector<double>& weights, const std::vector<UInt>& num_splits_per_block, UInt max_splits_per_block);
+
+// The following are specialized on the dimension Dim (2 or 3).  The 2D versions only consider the
+// i and j directions and require input_block.element_counts[2] == 1.  They are instantiated for
+// Dim = 2 and Dim = 3, and recursivelySplitBlock picks one based on getDimension()
+
 // computes a decomposition of roughly equally sized block with number of blocks <= num_split_blocks
-std::array<UInt, 3> computeEvenlyDivisibleBlockGrid(const std::shared_ptr<MeshBlock>& input_block, UInt num_split_blocks);
+template <UInt Dim>
+std::array<UInt, 3> computeEvenlyDivisibleBlockGrid(const SplitBlock& input_block, UInt num_split_blocks);
 
-std::array<std::vector<UInt>, 3> computeNumElementsPerBlock(const std::shared_ptr<MeshBlock>& input_block, const std::array<UInt, 3>& num_blocks_per_direction);
+template <UInt Dim>
+std::array<std::vector<UInt>, 3> computeNumElementsPerBlock(const SplitBlock& input_block, const std::array<UInt, 3>& num_blocks_per_direction);
 
-std::vector<SplitBlock> createSplitBlocks(const std::shared_ptr<MeshBlock>& input_block, const std::array<std::vector<UInt>, 3>& num_elem_per_block);
+template <UInt Dim>
+std::vector<SplitBlock> createSplitBlocks(const SplitBlock& input_block, const std::array<std::vector<UInt>, 3>& num_elem_per_block);
 
 std::vector<SplitBlock> recursivelySplitBlock(const SplitBlock& input_block, UInt num_split_blocks);
 
+// same as above, but appends the blocks to split_blocks rather than allocating a new vector
+void recursivelySplitBlock(const SplitBlock& input_block, UInt num_split_blocks, std::vector<SplitBlock>& split_blocks,
+                           RemainderStrategy remainder_strategy=RemainderStrategy::NestedSlabs);
+
 std::vector<SplitBlock> recursivelySplitBlock(std::shared_ptr<MeshBlock> input_block, UInt num_split_blocks);
 
-std::vector<SplitBlock> splitBlocks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, const std::vector<UInt>& num_splits_per_block);
+// memoizes recursivelySplitBlock for MeshBlocks, so the splits can be reused when the same
+// mesh is partitioned for several numbers of procs.  Safe to use from several threads at once
+class SplitCache
+{
+  public:
+    std::vector<SplitBlock> recursivelySplitBlock(const std::shared_ptr<MeshBlock>& input_block, UInt num_split_blocks);
+
+    // appends the blocks to split_blocks
+    void recursivelySplitBlock(const std::shared_ptr<MeshBlock>& input_block, UInt num_split_blocks,
+                               std::vector<SplitBlock>& split_blocks,
+                               RemainderStrategy remainder_strategy=RemainderStrategy::NestedSlabs);
+
+  private:
+    using Key = std::tuple<const MeshBlock*, UInt, RemainderStrategy>;
+    std::mutex m_mutex;
+    std::map<Key, std::vector<SplitBlock>> m_split_blocks;
+};
+
+std::vector<SplitBlock> splitBlocks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, const std::vector<UInt>& num_splits_per_block,
+                                    RemainderStrategy remainder_strategy=RemainderStrategy::NestedSlabs);
+
+std::vector<SplitBlock> splitBlocks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, const std::vector<UInt>& num_splits_per_block,
+                                    SplitCache& cache, RemainderStrategy remainder_strategy=RemainderStrategy::NestedSlabs);
 
 // returns a vector telling how many sub-blocks to split each block into
 std::vector<UInt> computeNumSubBlocks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs);
 
+// same as above, but for blocks with the given weights
+std::vector<UInt> computeNumSubBlocks(const std::vector<double>& weights, UInt nprocs);
+
+// same as above, but for integer weights.  Uses exact arithmetic
+std::vector<UInt> computeNumSubBlocks(const std::vector<IntWeight>& weights, UInt nprocs);
+
+// returns the number of sub-blocks to split each block into such that the total is num_sub_blocks,
+// no block is split into more than nprocs sub-blocks, and the maximum weight of a sub-block is
+// minimized.  num_sub_blocks must be in the range [number of blocks, number of blocks * nprocs]
+std::vector<UInt> computeNumSubBlocksMinMax(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, UInt num_sub_blocks);
+
+// same as above, but for blocks with the given weights
+std::vector<UInt> computeNumSubBlocksMinMax(const std::vector<double>& weights, UInt nprocs, UInt num_sub_blocks);
+
 double computeTotalWeight(const std::vector<SplitBlock>& blocks);
 
 UInt getProcWithMinWeightAndDifferentParent(const std::vector<std::vector<SplitBlock>>& blocks_on_proc, const std::shared_ptr<MeshBlock>& meshblock);
@@ -36,6 +89,18 @@ std::vector<std::vector<SplitBlock>> assignBlocksToProcs(std::vector<SplitBlock>
 
 std::vector<std::vector<SplitBlock>> preSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs);
 
+std::vector<std::vector<SplitBlock>> preSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, SplitCache& cache);
+
+// same as above, but uses options.weight_mode for computing the number of sub-blocks and
+// assigning them to procs, splits the MeshBlocks with options.remainder_strategy, and assigns
+// the sub-blocks by options.cost_model
+std::vector<std::vector<SplitBlock>> preSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs,
+                                              const PartitionOptions& options);
+
+// same as above, but reuses the MeshBlock splits in cache
+std::vector<std::vector<SplitBlock>> preSplit(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs,
+                                              const PartitionOptions& options, SplitCache& cache);
+
 } // namespace
 
 #endif
\ No newline at end of file
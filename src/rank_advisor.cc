@@ -0,0 +1,81 @@
+#include "rank_advisor.h"
+#include "final_split.h"
+
+#include <cmath>
+
+namespace structured_part {
+
+std::vector<UInt> getCandidateRankCounts(UInt nprocs_max)
+{
+  if (nprocs_max == 0)
+    throw std::runtime_error("number of procs must be greater than zero");
+
+  std::vector<UInt> nprocs_candidates;
+  for (UInt i=0; ; ++i)
+  {
+    UInt nprocs = std::floor(std::pow(2.0, i / 4.0));
+    if (nprocs >= nprocs_max)
+      break;
+
+    if (nprocs_candidates.size() == 0 || nprocs != nprocs_candidates.back())
+      nprocs_candidates.push_back(nprocs);
+  }
+  nprocs_candidates.push_back(nprocs_max);
+
+  return nprocs_candidates;
+}
+
+std::vector<RankCountEstimate> evaluateRankCounts(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks,
+                                                  const std::vector<UInt>& nprocs_candidates, double load_balance_factor,
+                                                  const CostModel& cost_model)
+{
+  double serial_cost = 0.0;
+  for (const auto& mesh_block : mesh_blocks)
+    serial_cost += computeBlockCost(SplitBlock(mesh_block), cost_model);
+
+  // large numbers of procs may not be able to reach the load balance factor, so use the
+  // best decomposition found rather than throwing
+  std::vector<RankCountEstimate> estimates;
+  for (UInt nprocs : nprocs_candidates)
+  {
+    double max_cost = 0.0;
+    for (const std::vector<SplitBlock>& blocks : finalSplit(mesh_blocks, nprocs, load_balance_factor, PartitionOptions()).blocks_on_procs)
+      max_cost = std::max(max_cost, computeTotalCost(blocks, cost_model));
+
+    double speedup = serial_cost / max_cost;
+    estimates.push_back({nprocs, max_cost, speedup, speedup / nprocs});
+  }
+
+  return estimates;
+}
+
+RankCountEstimate recommendRankCount(const std::vector<RankCountEstimate>& estimates, double tolerance)
+{
+  if (estimates.size() == 0)
+    throw std::runtime_error("no estimates to choose from");
+
+  double min_cost = estimates[0].max_cost;
+  for (const RankCountEstimate& estimate : estimates)
+    min_cost = std::min(min_cost, estimate.max_cost);
+
+  const RankCountEstimate* best = nullptr;
+  for (const RankCountEstimate& estimate : estimates)
+    if (estimate.max_cost <= min_cost * (1 + tolerance) && (!best || estimate.nprocs < best->nprocs))
+      best = &estimate;
+
+  return *best;
+}
+
+std::vector<std::vector<SplitBlock>> partitionMeshWithIdleRanks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs,
+                                                                double load_balance_factor, const CostModel& cost_model, double tolerance)
+{
+  std::vector<RankCountEstimate> estimates = evaluateRankCounts(mesh_blocks, getCandidateRankCounts(nprocs), load_balance_factor, cost_model);
+  UInt nprocs_active = recommendRankCount(estimates, tolerance).nprocs;
+
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = finalSplit(mesh_blocks, nprocs_active, load_balance_factor, PartitionOptions()).blocks_on_procs;
+  blocks_on_procs.resize(nprocs);
+
+  return blocks_on_procs;
+}
+
+}
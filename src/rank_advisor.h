@@ -0,0 +1,43 @@
+#ifndef STRUCTURED_PART_RANK_ADVISOR_H
+#define STRUCTURED_PART_RANK_ADVISOR_H
+
+#include "blocks.h"
+#include "cost_model.h"
+#include <vector>
+
+namespace structured_part {
+
+// modeled performance of partitioning the mesh onto nprocs ranks.  The time of a rank is
+// the cost of its blocks (see CostModel), so the per_face_area term models the halo exchange
+struct RankCountEstimate
+{
+  UInt nprocs;
+  double max_cost;    // modeled time of the slowest rank
+  double speedup;     // modeled time on one rank / max_cost
+  double efficiency;  // speedup / nprocs
+};
+
+// returns rank counts in [1, nprocs_max] to evaluate: four per doubling, plus nprocs_max
+std::vector<UInt> getCandidateRankCounts(UInt nprocs_max);
+
+// partitions the mesh onto each of the given numbers of ranks and returns the modeled performance
+// of each (entry i is for nprocs_candidates[i]).  If the load balance factor cannot be reached,
+// the best decomposition found is used
+std::vector<RankCountEstimate> evaluateRankCounts(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks,
+                                                  const std::vector<UInt>& nprocs_candidates, double load_balance_factor,
+                                                  const CostModel& cost_model);
+
+// returns the estimate with the fewest ranks whose modeled time is within a factor of (1 + tolerance)
+// of the smallest modeled time.  The modeled time is not monotonic in the number of ranks (it depends
+// on how evenly the blocks divide), so a small tolerance can give a much higher efficiency
+RankCountEstimate recommendRankCount(const std::vector<RankCountEstimate>& estimates, double tolerance=0);
+
+// partitions the mesh onto the number of ranks in [1, nprocs] recommended by recommendRankCount for
+// getCandidateRankCounts(nprocs).  The result has nprocs entries, and the ranks after the active ones
+// have no blocks
+std::vector<std::vector<SplitBlock>> partitionMeshWithIdleRanks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs,
+                                                                double load_balance_factor, const CostModel& cost_model, double tolerance=0);
+
+}
+
+#endif
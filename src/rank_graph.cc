@@ -0,0 +1,80 @@
+#include "rank_graph.h"
+#include "adjacency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+
+namespace structured_part {
+
+UInt RankGraph::getNumEdges() const
+{
+  UInt num_entries = 0;
+  for (const auto& rank_neighbors : neighbors)
+    num_entries += rank_neighbors.size();
+
+  return num_entries / 2;
+}
+
+RankGraph computeRankGraph(const std::vector<std::vector<SplitBlock>>& blocks_on_procs)
+{
+  UInt nprocs = blocks_on_procs.size();
+  RankGraph graph;
+  graph.vertex_weights.resize(nprocs, 0.0);
+  graph.neighbors.resize(nprocs);
+
+  std::vector<SplitBlock> blocks;
+  std::vector<UInt> block_ranks;
+  for (UInt proc=0; proc < nprocs; ++proc)
+    for (const SplitBlock& block : blocks_on_procs[proc])
+    {
+      blocks.push_back(block);
+      block_ranks.push_back(proc);
+      graph.vertex_weights[proc] += block.weight;
+    }
+
+  std::map<std::pair<UInt, UInt>, UInt> rank_pair_areas;
+  for (const BlockAdjacency& adjacency : computeBlockAdjacency(blocks))
+  {
+    UInt rank1 = block_ranks[adjacency.block1], rank2 = block_ranks[adjacency.block2];
+    if (rank1 != rank2)
+      rank_pair_areas[{std::min(rank1, rank2), std::max(rank1, rank2)}] += adjacency.area;
+  }
+
+  // the map is sorted by the first rank and then the second, so each list is sorted
+  for (auto& [ranks, area] : rank_pair_areas)
+    graph.neighbors[ranks.first].emplace_back(ranks.second, area);
+
+  for (auto& [ranks, area] : rank_pair_areas)
+    graph.neighbors[ranks.second].emplace_back(ranks.first, area);
+
+  for (auto& rank_neighbors : graph.neighbors)
+    std::sort(rank_neighbors.begin(), rank_neighbors.end());
+
+  return graph;
+}
+
+void writeMetisGraph(std::ostream& os, const RankGraph& graph, double weight_scale)
+{
+  // fmt 011: vertex weights and edge weights.  Vertices are numbered from 1
+  os << graph.vertex_weights.size() << " " << graph.getNumEdges() << " 011\n";
+  for (UInt rank=0; rank < graph.vertex_weights.size(); ++rank)
+  {
+    os << std::llround(graph.vertex_weights[rank] * weight_scale);
+    for (auto& [neighbor, area] : graph.neighbors[rank])
+      os << " " << neighbor + 1 << " " << area;
+    os << "\n";
+  }
+}
+
+void writeMetisGraph(const std::string& fname, const RankGraph& graph, double weight_scale)
+{
+  std::ofstream os(fname);
+  if (!os)
+    throw std::runtime_error("could not open file " + fname);
+
+  writeMetisGraph(os, graph, weight_scale);
+}
+
+}
@@ -0,0 +1,34 @@
+#ifndef STRUCTURED_PART_RANK_GRAPH_H
+#define STRUCTURED_PART_RANK_GRAPH_H
+
+#include "blocks.h"
+#include <string>
+#include <vector>
+
+namespace structured_part {
+
+// communication graph between ranks
+struct RankGraph
+{
+  std::vector<double> vertex_weights;  // total SplitBlock weight of each rank
+
+  // for each rank, the ranks it shares faces with and the number of element faces they
+  // share (the halo area), sorted by rank
+  std::vector<std::vector<std::pair<UInt, UInt>>> neighbors;
+
+  UInt getNumEdges() const;
+};
+
+// computes the rank graph using computeBlockAdjacency()
+RankGraph computeRankGraph(const std::vector<std::vector<SplitBlock>>& blocks_on_procs);
+
+// writes the graph in the METIS graph file format (also read by Scotch's gcv and KaHIP), with
+// vertex and edge weights.  METIS requires integer vertex weights, so the vertex weights are
+// multiplied by weight_scale and rounded
+void writeMetisGraph(std::ostream& os, const RankGraph& graph, double weight_scale=1);
+
+void writeMetisGraph(const std::string& fname, const RankGraph& graph, double weight_scale=1);
+
+}
+
+#endif
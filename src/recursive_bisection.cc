@@ -0,0 +1,242 @@
+#include "recursive_bisection.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <thread>
+
+namespace structured_part {
+
+namespace {
+
+double computeTotalWeight(const std::vector<SplitBlock>& blocks)
+{
+  double weight = 0;
+  for (const SplitBlock& block : blocks)
+    weight += block.weight;
+
+  return weight;
+}
+
+// bisects blocks for the procs [first_proc, first_proc + nprocs), with up to num_threads threads,
+// and passes the blocks of each proc to proc_sink.  With one thread, the procs are passed in order
+void bisectRecursively(std::vector<SplitBlock>&& blocks, UInt first_proc, UInt nprocs, double tolerance_factor, UInt num_threads,
+                       const ProcBlocksSink& proc_sink)
+{
+  if (nprocs == 1)
+  {
+    proc_sink(first_proc, std::move(blocks));
+    return;
+  }
+
+  UInt nprocs_left = nprocs / 2;
+  double total_weight = computeTotalWeight(blocks);
+  double target_weight = total_weight * nprocs_left / nprocs;
+  auto [blocks_left, blocks_right] = bisectBlocks(blocks, target_weight, tolerance_factor * total_weight / nprocs);
+
+  // only the blocks of the subtrees that have not been bisected yet are kept
+  std::vector<SplitBlock>().swap(blocks);
+
+  // the procs of the subtrees are disjoint, so the subtrees need no synchronization
+  if (num_threads > 1)
+  {
+    UInt num_threads_left = num_threads / 2;
+    std::exception_ptr exception;
+    std::thread thread([&]()
+    {
+      try
+      {
+        bisectRecursively(std::move(blocks_left), first_proc, nprocs_left, tolerance_factor, num_threads_left, proc_sink);
+      } catch (...)
+      {
+        exception = std::current_exception();
+      }
+    });
+
+    try
+    {
+      bisectRecursively(std::move(blocks_right), first_proc + nprocs_left, nprocs - nprocs_left, tolerance_factor,
+                        num_threads - num_threads_left, proc_sink);
+    } catch (...)
+    {
+      thread.join();
+      throw;
+    }
+
+    thread.join();
+    if (exception)
+      std::rethrow_exception(exception);
+  } else
+  {
+    bisectRecursively(std::move(blocks_left), first_proc, nprocs_left, tolerance_factor, 1, proc_sink);
+    bisectRecursively(std::move(blocks_right), first_proc + nprocs_left, nprocs - nprocs_left, tolerance_factor, 1, proc_sink);
+  }
+}
+
+void checkOptions(UInt nprocs, const PartitionOptions& options)
+{
+  if (nprocs == 0)
+    throw std::runtime_error("nprocs must be greater than zero");
+
+  if (options.weight_mode != WeightMode::Floating || !options.cost_model.isWeightOnly())
+    throw std::runtime_error("the recursive bisection engine only supports floating point weights without a cost model");
+
+  if (options.max_memory_per_rank != std::numeric_limits<double>::infinity())
+    throw std::runtime_error("the recursive bisection engine does not support a memory limit");
+}
+
+std::vector<SplitBlock> getBlocks(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks)
+{
+  std::vector<SplitBlock> blocks;
+  for (const auto& mesh_block : mesh_blocks)
+    blocks.emplace_back(mesh_block);
+
+  return blocks;
+}
+
+void setImbalance(PartitionResult& result, double max_weight, double total_weight, UInt nprocs, double load_balance_factor)
+{
+  double avg_weight = total_weight / nprocs;
+  result.imbalance = avg_weight > 0 ? max_weight / avg_weight - 1 : 0;
+  result.status = result.imbalance <= load_balance_factor ? PartitionStatus::Balanced : PartitionStatus::Unbalanced;
+}
+
+}
+
+std::pair<std::vector<SplitBlock>, std::vector<SplitBlock>> bisectBlocks(const std::vector<SplitBlock>& blocks, double target_weight,
+                                                                         double tolerance)
+{
+  std::vector<UInt> idxs(blocks.size());
+  for (UInt i=0; i < blocks.size(); ++i)
+    idxs[i] = i;
+  std::stable_sort(idxs.begin(), idxs.end(), [&](UInt lhs, UInt rhs) { return blocks[lhs].weight > blocks[rhs].weight; });
+
+  std::vector<SplitBlock> blocks_left, blocks_right;
+  std::vector<bool> is_left(blocks.size(), false);
+  double weight_left = 0;
+  for (UInt idx : idxs)
+    if (weight_left + blocks[idx].weight <= target_weight)
+    {
+      is_left[idx] = true;
+      weight_left += blocks[idx].weight;
+    }
+
+  // every block on the right is heavier than the deficit, so any of them can be cut
+  double deficit = target_weight - weight_left;
+  constexpr UInt NoCut = std::numeric_limits<UInt>::max();
+  UInt cut_idx = NoCut, cut_dir = 0, cut_nelem = 0;
+  if (deficit > 0)
+  {
+    struct Cut
+    {
+      UInt idx;
+      UInt dir;
+      UInt nelem;
+      double error;
+      UInt area;
+    };
+
+    std::vector<Cut> cuts;
+    double min_error = deficit;  // not cutting anything
+    for (UInt idx=0; idx < blocks.size(); ++idx)
+    {
+      // a block without weight cannot make up any of the deficit
+      const SplitBlock& block = blocks[idx];
+      if (is_left[idx] || block.weight <= 0)
+        continue;
+
+      UInt dim = getDimension(block.meshblock->element_counts);
+      for (UInt dir=0; dir < dim; ++dir)
+      {
+        UInt count = block.element_counts[dir];
+        UInt nelem = std::min(UInt(std::round(count * deficit / block.weight)), count - 1);
+        if (nelem == 0)
+          continue;
+
+        double error = std::abs(block.weight * nelem / count - deficit);
+        cuts.push_back({idx, dir, nelem, error, prod(block.element_counts) / count});
+        min_error = std::min(min_error, error);
+      }
+    }
+
+    UInt min_area = std::numeric_limits<UInt>::max();
+    for (const Cut& cut : cuts)
+      if (cut.error <= min_error + tolerance && cut.area < min_area)
+      {
+        min_area = cut.area;
+        cut_idx  = cut.idx;
+        cut_dir  = cut.dir;
+        cut_nelem = cut.nelem;
+      }
+  }
+
+  for (UInt idx=0; idx < blocks.size(); ++idx)
+  {
+    if (idx == cut_idx)
+    {
+      auto [block1, block2] = splitBlock(blocks[idx], static_cast<SplitDirection>(cut_dir), cut_nelem);
+      blocks_left.push_back(block1);
+      blocks_right.push_back(block2);
+    } else if (is_left[idx])
+      blocks_left.push_back(blocks[idx]);
+    else
+      blocks_right.push_back(blocks[idx]);
+  }
+
+  return {blocks_left, blocks_right};
+}
+
+PartitionResult recursiveBisection(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                                   const PartitionOptions& options)
+{
+  checkOptions(nprocs, options);
+
+  UInt num_threads = options.num_threads;
+  if (num_threads == 0)
+    num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+  std::vector<SplitBlock> blocks = getBlocks(mesh_blocks);
+  double total_weight = computeTotalWeight(blocks);
+
+  // the cuts at each level can err by half the load balance factor, which leaves the
+  // other half for the rounding of cuts at the levels below
+  PartitionResult result;
+  result.blocks_on_procs.resize(nprocs);
+  auto proc_sink = [&](UInt proc, std::vector<SplitBlock>&& blocks_on_proc)
+  {
+    result.blocks_on_procs[proc] = std::move(blocks_on_proc);
+  };
+  bisectRecursively(std::move(blocks), 0, nprocs, load_balance_factor / 2, num_threads, proc_sink);
+
+  double max_weight = 0;
+  for (const auto& blocks_on_proc : result.blocks_on_procs)
+    max_weight = std::max(max_weight, computeTotalWeight(blocks_on_proc));
+
+  setImbalance(result, max_weight, total_weight, nprocs, load_balance_factor);
+
+  return result;
+}
+
+PartitionResult recursiveBisection(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                                   const PartitionOptions& options, const ProcBlocksSink& proc_sink)
+{
+  checkOptions(nprocs, options);
+
+  std::vector<SplitBlock> blocks = getBlocks(mesh_blocks);
+  double total_weight = computeTotalWeight(blocks);
+
+  double max_weight = 0;
+  auto sink = [&](UInt proc, std::vector<SplitBlock>&& blocks_on_proc)
+  {
+    max_weight = std::max(max_weight, computeTotalWeight(blocks_on_proc));
+    proc_sink(proc, std::move(blocks_on_proc));
+  };
+  bisectRecursively(std::move(blocks), 0, nprocs, load_balance_factor / 2, 1, sink);
+
+  PartitionResult result;
+  setImbalance(result, max_weight, total_weight, nprocs, load_balance_factor);
+
+  return result;
+}
+
+}
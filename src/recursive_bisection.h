@@ -0,0 +1,41 @@
+#ifndef STRUCTURED_PART_RECURSIVE_BISECTION_H
+#define STRUCTURED_PART_RECURSIVE_BISECTION_H
+
+#include "blocks.h"
+#include "partition_options.h"
+#include <functional>
+#include <vector>
+
+namespace structured_part {
+
+// splits blocks into two sets, the first of which has approximately target_weight.  Whole blocks
+// are put in the first set, largest first, while they fit, and then at most one block is cut with
+// splitBlock(block, dir, nelem) to make up the difference.  The block and direction are chosen to
+// minimize the error in the weight, and among those within tolerance of the smallest error, the
+// area of the cut
+std::pair<std::vector<SplitBlock>, std::vector<SplitBlock>> bisectBlocks(const std::vector<SplitBlock>& blocks, double target_weight,
+                                                                         double tolerance);
+
+// Recursive bisection engine (PartitionEngine::RecursiveBisection): the MeshBlocks are bisected
+// into two sets with weights in proportion to floor(nprocs/2) and nprocs - floor(nprocs/2), and each
+// set is bisected recursively until there is one proc.  A set never contains two blocks of the same
+// MeshBlock, so no proc does either, and there are at most (number of MeshBlocks + nprocs - 1) blocks.
+// The load balance factor only sets the tolerance of the cuts and the returned status, there is no
+// final split.  Independent subtrees are bisected on options.num_threads threads
+PartitionResult recursiveBisection(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                                   const PartitionOptions& options);
+
+// receives all the blocks of one proc
+using ProcBlocksSink = std::function<void(UInt proc, std::vector<SplitBlock>&& blocks)>;
+
+// same as above, but passes the blocks of each proc to proc_sink, in order of proc, as soon as the
+// bisection of the proc is finished, and returns an empty blocks_on_procs.  Only the blocks of the
+// subtrees that have not been bisected yet are held, which is at most the number of MeshBlocks plus
+// the depth of the tree, rather than the whole decomposition.  The subtrees are bisected on one
+// thread, so the procs are passed in order
+PartitionResult recursiveBisection(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                                   const PartitionOptions& options, const ProcBlocksSink& proc_sink);
+
+}
+
+#endif
@@ -0,0 +1,327 @@
+#include "refine_assignment.h"
+#include "adjacency.h"
+#include "assign_blocks_to_procs.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace structured_part {
+
+namespace {
+
+class AssignmentRefiner
+{
+  public:
+    AssignmentRefiner(const std::vector<std::vector<SplitBlock>>& blocks_on_procs, CommObjective objective) :
+      m_objective(objective),
+      m_rank_weights(blocks_on_procs.size(), 0.0),
+      m_blocks_on_rank(blocks_on_procs.size()),
+      m_num_neighbors(blocks_on_procs.size(), 0)
+    {
+      for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
+        for (const SplitBlock& split_block : blocks_on_procs[proc])
+        {
+          m_blocks.push_back(split_block);
+          m_rank_of.push_back(proc);
+          m_blocks_on_rank[proc].push_back(m_blocks.size() - 1);
+          m_rank_weights[proc] += split_block.weight;
+          m_parents_on_rank[{split_block.meshblock.get(), proc}]++;
+        }
+
+      m_neighbors.resize(m_blocks.size());
+      for (const BlockAdjacency& adj : computeBlockAdjacency(m_blocks))
+      {
+        m_neighbors[adj.block1].emplace_back(adj.block2, adj.area);
+        m_neighbors[adj.block2].emplace_back(adj.block1, adj.area);
+
+        if (m_rank_of[adj.block1] != m_rank_of[adj.block2])
+          addRankPairArea(m_rank_of[adj.block1], m_rank_of[adj.block2], adj.area);
+      }
+    }
+
+    CommStats getCommStats() const { return m_stats; }
+
+    double computeMaxAllowedWeight(double load_balance_factor) const
+    {
+      double total_weight = 0.0, max_weight = 0.0;
+      for (double weight : m_rank_weights)
+      {
+        total_weight += weight;
+        max_weight = std::max(max_weight, weight);
+      }
+
+      return std::max(total_weight / m_rank_weights.size() * (1 + load_balance_factor), max_weight);
+    }
+
+    // tries to find and apply the best move or swap involving block i.  Returns 0 if
+    // nothing was done, 1 for a move, and 2 for a swap
+    int improveBlock(UInt i, double max_allowed_weight)
+    {
+      // the candidates are the ranks of i's neighbors and the ranks those ranks already
+      // communicate with, because moving i to any other rank can only create new pairs
+      UInt rank_i = m_rank_of[i];
+      std::set<UInt> candidate_ranks;
+      for (auto& [j, area_j] : m_neighbors[i])
+      {
+        candidate_ranks.insert(m_rank_of[j]);
+        for (UInt k : m_blocks_on_rank[m_rank_of[j]])
+          for (auto& [l, area_l] : m_neighbors[k])
+            candidate_ranks.insert(m_rank_of[l]);
+      }
+      candidate_ranks.erase(rank_i);
+
+      CommStats best_stats = m_stats;
+      UInt best_rank = -1, best_swap = -1;
+      for (UInt rank : candidate_ranks)
+      {
+        if (canMove(i, rank, max_allowed_weight))
+        {
+          CommStats stats = evaluate(i, rank, UInt(-1));
+          if (isBetter(stats, best_stats))
+          {
+            best_stats = stats;
+            best_rank = rank;
+            best_swap = -1;
+          }
+        }
+
+        for (UInt j : m_blocks_on_rank[rank])
+        {
+          if (canSwap(i, j, max_allowed_weight))
+          {
+            CommStats stats = evaluate(i, rank, j);
+            if (isBetter(stats, best_stats))
+            {
+              best_stats = stats;
+              best_rank = rank;
+              best_swap = j;
+            }
+          }
+        }
+      }
+
+      if (best_rank == UInt(-1))
+        return 0;
+
+      apply(i, best_rank, best_swap);
+      return best_swap == UInt(-1) ? 1 : 2;
+    }
+
+    UInt getNumBlocks() const { return m_blocks.size(); }
+
+    std::vector<std::vector<SplitBlock>> getBlocksOnProcs() const
+    {
+      std::vector<std::vector<SplitBlock>> blocks_on_procs(m_blocks_on_rank.size());
+      for (UInt i=0; i < m_blocks.size(); ++i)
+        blocks_on_procs[m_rank_of[i]].push_back(m_blocks[i]);
+
+      return blocks_on_procs;
+    }
+
+  private:
+    bool hasParent(UInt rank, const SplitBlock& block, UInt ignore_block) const
+    {
+      auto it = m_parents_on_rank.find({block.meshblock.get(), rank});
+      if (it == m_parents_on_rank.end() || it->second == 0)
+        return false;
+
+      return !(it->second == 1 && ignore_block != UInt(-1) && m_blocks[ignore_block].meshblock == block.meshblock);
+    }
+
+    bool canMove(UInt i, UInt rank, double max_allowed_weight) const
+    {
+      // don't leave a rank with nothing to do
+      return m_blocks_on_rank[m_rank_of[i]].size() > 1 &&
+             m_rank_weights[rank] + m_blocks[i].weight <= max_allowed_weight &&
+             !hasParent(rank, m_blocks[i], UInt(-1));
+    }
+
+    bool canSwap(UInt i, UInt j, double max_allowed_weight) const
+    {
+      UInt rank_i = m_rank_of[i], rank_j = m_rank_of[j];
+      double delta = m_blocks[j].weight - m_blocks[i].weight;
+      return m_rank_weights[rank_i] + delta <= max_allowed_weight &&
+             m_rank_weights[rank_j] - delta <= max_allowed_weight &&
+             !hasParent(rank_j, m_blocks[i], j) &&
+             !hasParent(rank_i, m_blocks[j], i);
+    }
+
+    bool isBetter(const CommStats& lhs, const CommStats& rhs) const
+    {
+      if (m_objective == CommObjective::NumNeighbors)
+        return lhs.num_neighbors < rhs.num_neighbors ||
+               (lhs.num_neighbors == rhs.num_neighbors && lhs.max_neighbors_per_rank < rhs.max_neighbors_per_rank);
+      else
+        return lhs.max_neighbors_per_rank < rhs.max_neighbors_per_rank ||
+               (lhs.max_neighbors_per_rank == rhs.max_neighbors_per_rank && lhs.num_neighbors < rhs.num_neighbors);
+    }
+
+    // returns the stats that would result from moving block i to rank (and block swap_block
+    // to the rank of block i, if swap_block != -1).  Only the rank pairs are changed and
+    // restored, so m_blocks_on_rank can be iterated over while evaluating
+    CommStats evaluate(UInt i, UInt rank, UInt swap_block)
+    {
+      UInt rank_i = m_rank_of[i];
+      changeRank(i, rank);
+      if (swap_block != UInt(-1))
+        changeRank(swap_block, rank_i);
+
+      CommStats stats = m_stats;
+
+      if (swap_block != UInt(-1))
+        changeRank(swap_block, rank);
+      changeRank(i, rank_i);
+
+      return stats;
+    }
+
+    void apply(UInt i, UInt rank, UInt swap_block)
+    {
+      UInt rank_i = m_rank_of[i];
+      moveBlock(i, rank);
+      if (swap_block != UInt(-1))
+        moveBlock(swap_block, rank_i);
+    }
+
+    void moveBlock(UInt i, UInt new_rank)
+    {
+      UInt old_rank = m_rank_of[i];
+      if (old_rank == new_rank)
+        return;
+
+      changeRank(i, new_rank);
+
+      auto& old_blocks = m_blocks_on_rank[old_rank];
+      old_blocks.erase(std::find(old_blocks.begin(), old_blocks.end(), i));
+      m_blocks_on_rank[new_rank].push_back(i);
+
+      m_rank_weights[old_rank] -= m_blocks[i].weight;
+      m_rank_weights[new_rank] += m_blocks[i].weight;
+      m_parents_on_rank[{m_blocks[i].meshblock.get(), old_rank}]--;
+      m_parents_on_rank[{m_blocks[i].meshblock.get(), new_rank}]++;
+    }
+
+    // updates the rank of block i and the rank pairs, but not the other per-rank data
+    void changeRank(UInt i, UInt new_rank)
+    {
+      UInt old_rank = m_rank_of[i];
+      for (auto& [j, area] : m_neighbors[i])
+      {
+        if (m_rank_of[j] != old_rank)
+          removeRankPairArea(old_rank, m_rank_of[j], area);
+
+        if (m_rank_of[j] != new_rank)
+          addRankPairArea(new_rank, m_rank_of[j], area);
+      }
+
+      m_rank_of[i] = new_rank;
+    }
+
+    void addRankPairArea(UInt rank1, UInt rank2, UInt area)
+    {
+      UInt& pair_area = m_rank_pair_areas[std::minmax(rank1, rank2)];
+      if (pair_area == 0)
+      {
+        m_stats.num_neighbors++;
+        changeNumNeighbors(rank1, 1);
+        changeNumNeighbors(rank2, 1);
+      }
+
+      pair_area += area;
+      m_stats.halo_area += area;
+    }
+
+    void removeRankPairArea(UInt rank1, UInt rank2, UInt area)
+    {
+      UInt& pair_area = m_rank_pair_areas[std::minmax(rank1, rank2)];
+      pair_area -= area;
+      if (pair_area == 0)
+      {
+        m_stats.num_neighbors--;
+        changeNumNeighbors(rank1, -1);
+        changeNumNeighbors(rank2, -1);
+      }
+
+      m_stats.halo_area -= area;
+    }
+
+    void changeNumNeighbors(UInt rank, int delta)
+    {
+      UInt& num_neighbors = m_num_neighbors[rank];
+      if (num_neighbors > 0)
+      {
+        auto it = m_num_neighbors_counts.find(num_neighbors);
+        if (--(it->second) == 0)
+          m_num_neighbors_counts.erase(it);
+      }
+
+      num_neighbors += delta;
+      if (num_neighbors > 0)
+        m_num_neighbors_counts[num_neighbors]++;
+
+      m_stats.max_neighbors_per_rank = m_num_neighbors_counts.empty() ? 0 : m_num_neighbors_counts.rbegin()->first;
+    }
+
+    CommObjective m_objective;
+    std::vector<SplitBlock> m_blocks;
+    std::vector<UInt> m_rank_of;
+    std::vector<std::vector<std::pair<UInt, UInt>>> m_neighbors;
+    std::vector<double> m_rank_weights;
+    std::vector<std::vector<UInt>> m_blocks_on_rank;
+    std::map<std::pair<const MeshBlock*, UInt>, UInt> m_parents_on_rank;
+    std::map<std::pair<UInt, UInt>, UInt> m_rank_pair_areas;
+    std::vector<UInt> m_num_neighbors;
+    std::map<UInt, UInt> m_num_neighbors_counts;  // histogram of m_num_neighbors, used to get the max
+    CommStats m_stats;
+};
+
+}
+
+CommStats computeCommStats(const std::vector<std::vector<SplitBlock>>& blocks_on_procs)
+{
+  return AssignmentRefiner(blocks_on_procs, CommObjective::NumNeighbors).getCommStats();
+}
+
+RefinementStats refineAssignment(std::vector<std::vector<SplitBlock>>& blocks_on_procs, double load_balance_factor,
+                                 CommObjective objective, UInt max_passes)
+{
+  AssignmentRefiner refiner(blocks_on_procs, objective);
+  double max_allowed_weight = refiner.computeMaxAllowedWeight(load_balance_factor);
+
+  RefinementStats stats;
+  stats.initial = refiner.getCommStats();
+  for (UInt pass=0; pass < max_passes; ++pass)
+  {
+    bool improved = false;
+    for (UInt i=0; i < refiner.getNumBlocks(); ++i)
+    {
+      int result = refiner.improveBlock(i, max_allowed_weight);
+      if (result == 1)
+        stats.num_moves++;
+      else if (result == 2)
+        stats.num_swaps++;
+
+      improved = improved || result != 0;
+    }
+
+    if (!improved)
+      break;
+  }
+
+  stats.final = refiner.getCommStats();
+  blocks_on_procs = refiner.getBlocksOnProcs();
+
+  return stats;
+}
+
+std::ostream& operator<<(std::ostream& os, const RefinementStats& stats)
+{
+  os << "neighbor pairs " << stats.initial.num_neighbors << " -> " << stats.final.num_neighbors
+     << ", max neighbors per rank " << stats.initial.max_neighbors_per_rank << " -> " << stats.final.max_neighbors_per_rank
+     << ", halo area " << stats.initial.halo_area << " -> " << stats.final.halo_area
+     << " (" << stats.num_moves << " moves, " << stats.num_swaps << " swaps)";
+  return os;
+}
+
+}
@@ -0,0 +1,47 @@
+#ifndef STRUCTURED_PART_REFINE_ASSIGNMENT_H
+#define STRUCTURED_PART_REFINE_ASSIGNMENT_H
+
+#include "blocks.h"
+#include <vector>
+
+namespace structured_part {
+
+// Note: because a rank never has two sub-blocks of the same MeshBlock, every face shared
+// by two sub-blocks is always a face between different ranks, so the total halo area is
+// fixed by the split and only the rank communication pattern can be improved
+enum class CommObjective
+{
+  NumNeighbors,        // minimize the number of pairs of ranks that communicate
+  MaxNeighborsPerRank  // minimize the maximum number of ranks any rank communicates with
+};
+
+struct CommStats
+{
+  UInt halo_area = 0;               // number of element faces shared between different ranks
+  UInt num_neighbors = 0;           // number of pairs of ranks that share at least one face
+  UInt max_neighbors_per_rank = 0;
+};
+
+struct RefinementStats
+{
+  CommStats initial;
+  CommStats final;
+  UInt num_moves = 0;
+  UInt num_swaps = 0;
+};
+
+CommStats computeCommStats(const std::vector<std::vector<SplitBlock>>& blocks_on_procs);
+
+// Kernighan-Lin style refinement of an existing assignment (for example, the output of
+// assignBlocksToProcs or partitionMesh): greedily moves sub-blocks to the rank of a
+// neighboring sub-block, or swaps sub-blocks between ranks, when doing so reduces the
+// objective.  The one-sub-block-per-MeshBlock-per-rank rule is preserved, and
+// no rank is made heavier than max(avg weight * (1 + load_balance_factor), current max weight)
+RefinementStats refineAssignment(std::vector<std::vector<SplitBlock>>& blocks_on_procs, double load_balance_factor,
+                                 CommObjective objective=CommObjective::NumNeighbors, UInt max_passes=10);
+
+std::ostream& operator<<(std::ostream& os, const RefinementStats& stats);
+
+}
+
+#endif
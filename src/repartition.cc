@@ -0,0 +1,485 @@
+#include "repartition.h"
+#include "assign_blocks_to_procs.h"
+#include "structured_part.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <unordered_set>
+
+namespace structured_part {
+
+namespace {
+
+UInt computeOverlap(const SplitBlock& lhs, const SplitBlock& rhs)
+{
+  UInt volume = 1;
+  for (UInt d=0; d < 3; ++d)
+  {
+    UInt lo = std::max(lhs.mesh_offsets[d], rhs.mesh_offsets[d]);
+    UInt hi = std::min(lhs.mesh_offsets[d] + lhs.element_counts[d], rhs.mesh_offsets[d] + rhs.element_counts[d]);
+    if (hi <= lo)
+      return 0;
+
+    volume *= hi - lo;
+  }
+
+  return volume;
+}
+
+double computeImbalance(const std::vector<double>& weights_on_procs)
+{
+  double max_weight = 0, total_weight = 0;
+  for (double weight : weights_on_procs)
+  {
+    max_weight = std::max(max_weight, weight);
+    total_weight += weight;
+  }
+
+  double avg_weight = total_weight / weights_on_procs.size();
+  return avg_weight > 0 ? max_weight / avg_weight - 1 : 0;
+}
+
+std::vector<std::shared_ptr<MeshBlock>> getMeshBlocks(const std::vector<std::vector<SplitBlock>>& blocks_on_procs)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks;
+  std::unordered_set<const MeshBlock*> seen;
+  for (auto& blocks : blocks_on_procs)
+    for (auto& block : blocks)
+      if (seen.insert(block.meshblock.get()).second)
+        mesh_blocks.push_back(block.meshblock);
+
+  return mesh_blocks;
+}
+
+// partitions the MeshBlocks of blocks_on_procs from scratch, and numbers the new procs so each
+// keeps as much of the blocks of an old proc as possible
+PartitionResult partitionFromScratch(const std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt new_nprocs,
+                                     double load_balance_factor, bool allow_non_adjacent_siblings)
+{
+  PartitionOptions options;
+  options.allow_non_adjacent_siblings = allow_non_adjacent_siblings;
+  PartitionResult partition = partitionMesh(getMeshBlocks(blocks_on_procs), new_nprocs, load_balance_factor, options);
+
+  std::vector<std::tuple<UInt, UInt, UInt>> overlaps;  // overlap, new proc, old proc
+  for (UInt new_proc=0; new_proc < new_nprocs; ++new_proc)
+    for (UInt old_proc=0; old_proc < std::min(new_nprocs, UInt(blocks_on_procs.size())); ++old_proc)
+    {
+      UInt overlap = 0;
+      for (const SplitBlock& new_block : partition.blocks_on_procs[new_proc])
+        for (const SplitBlock& old_block : blocks_on_procs[old_proc])
+          if (new_block.meshblock == old_block.meshblock)
+            overlap += computeOverlap(new_block, old_block);
+
+      if (overlap > 0)
+        overlaps.emplace_back(overlap, new_proc, old_proc);
+    }
+  std::sort(overlaps.begin(), overlaps.end(), std::greater<std::tuple<UInt, UInt, UInt>>());
+
+  std::vector<UInt> new_to_old(new_nprocs, new_nprocs);
+  std::vector<bool> is_old_proc_used(new_nprocs, false);
+  for (auto& [overlap, new_proc, old_proc] : overlaps)
+    if (new_to_old[new_proc] == new_nprocs && !is_old_proc_used[old_proc])
+    {
+      new_to_old[new_proc] = old_proc;
+      is_old_proc_used[old_proc] = true;
+    }
+
+  UInt old_proc = 0;
+  for (UInt new_proc=0; new_proc < new_nprocs; ++new_proc)
+    if (new_to_old[new_proc] == new_nprocs)
+    {
+      while (is_old_proc_used[old_proc])
+        old_proc++;
+      new_to_old[new_proc] = old_proc;
+      is_old_proc_used[old_proc] = true;
+    }
+
+  std::vector<std::vector<SplitBlock>> relabelled_blocks_on_procs(new_nprocs);
+  for (UInt new_proc=0; new_proc < new_nprocs; ++new_proc)
+    relabelled_blocks_on_procs[new_to_old[new_proc]] = std::move(partition.blocks_on_procs[new_proc]);
+  partition.blocks_on_procs = std::move(relabelled_blocks_on_procs);
+
+  return partition;
+}
+
+// box of elements of a MeshBlock, [lo, hi) in each direction
+struct Box
+{
+  std::array<UInt, 3> lo;
+  std::array<UInt, 3> hi;
+};
+
+Box getBox(const SplitBlock& block)
+{
+  Box box{block.mesh_offsets, block.mesh_offsets};
+  for (UInt d=0; d < 3; ++d)
+    box.hi[d] += block.element_counts[d];
+
+  return box;
+}
+
+bool intersects(const Box& lhs, const Box& rhs)
+{
+  for (UInt d=0; d < 3; ++d)
+    if (std::max(lhs.lo[d], rhs.lo[d]) >= std::min(lhs.hi[d], rhs.hi[d]))
+      return false;
+
+  return true;
+}
+
+bool contains(const Box& outer, const Box& inner)
+{
+  for (UInt d=0; d < 3; ++d)
+    if (inner.lo[d] < outer.lo[d] || inner.hi[d] > outer.hi[d])
+      return false;
+
+  return true;
+}
+
+Box getBoundingBox(const Box& lhs, const Box& rhs)
+{
+  Box box;
+  for (UInt d=0; d < 3; ++d)
+  {
+    box.lo[d] = std::min(lhs.lo[d], rhs.lo[d]);
+    box.hi[d] = std::max(lhs.hi[d], rhs.hi[d]);
+  }
+
+  return box;
+}
+
+UInt getVolume(const Box& box)
+{
+  return (box.hi[0] - box.lo[0]) * (box.hi[1] - box.lo[1]) * (box.hi[2] - box.lo[2]);
+}
+
+// a block of the MeshBlock being re-cut, and the proc it is on (NoProc if it is orphaned)
+struct RegionBlock
+{
+  SplitBlock block;
+  UInt proc;
+};
+
+constexpr UInt NoProc = std::numeric_limits<UInt>::max();
+
+// Re-cuts part of the MeshBlock of orphan, for when every proc has a sibling of orphan.  A box
+// region around orphan is grown out of whole blocks of the MeshBlock until the procs that have
+// blocks in it can absorb its weight (or it is the whole MeshBlock).  The region is then
+// partitioned into one block per proc, and each new block is given to the proc whose old block it
+// overlaps the most, so only the region is migrated.  Orphans of the same MeshBlock in the region
+// are removed from orphaned_blocks.  Returns the number of elements in the region
+UInt recutRegion(const SplitBlock& orphan, std::vector<SplitBlock>& orphaned_blocks,
+                 std::vector<std::vector<SplitBlock>>& new_blocks_on_procs, std::vector<double>& weights_on_procs,
+                 double max_weight, double load_balance_factor)
+{
+  const std::shared_ptr<MeshBlock>& meshblock = orphan.meshblock;
+  std::vector<RegionBlock> meshblock_blocks = {{orphan, NoProc}};
+  for (const SplitBlock& block : orphaned_blocks)
+    if (block.meshblock == meshblock)
+      meshblock_blocks.push_back({block, NoProc});
+
+  for (UInt proc=0; proc < new_blocks_on_procs.size(); ++proc)
+    for (const SplitBlock& block : new_blocks_on_procs[proc])
+      if (block.meshblock == meshblock)
+        meshblock_blocks.push_back({block, proc});
+
+  // extends the region to whole blocks.  The procs in the region can only have one block of the
+  // MeshBlock after the re-cut, so the region also includes all their other blocks
+  auto closeRegion = [&](Box region)
+  {
+    bool changed = true;
+    while (changed)
+    {
+      changed = false;
+      std::unordered_set<UInt> procs_in_region;
+      for (const RegionBlock& region_block : meshblock_blocks)
+        if (intersects(region, getBox(region_block.block)) && region_block.proc != NoProc)
+          procs_in_region.insert(region_block.proc);
+
+      for (const RegionBlock& region_block : meshblock_blocks)
+      {
+        Box box = getBox(region_block.block);
+        if ((intersects(region, box) || procs_in_region.count(region_block.proc)) && !contains(region, box))
+        {
+          region = getBoundingBox(region, box);
+          changed = true;
+        }
+      }
+    }
+
+    return region;
+  };
+
+  // the procs with blocks in the region, and their weight outside of it
+  auto getRegionProcs = [&](const Box& region)
+  {
+    std::map<UInt, double> other_weights;
+    for (const RegionBlock& region_block : meshblock_blocks)
+      if (region_block.proc != NoProc && contains(region, getBox(region_block.block)))
+      {
+        auto it = other_weights.emplace(region_block.proc, weights_on_procs[region_block.proc]).first;
+        it->second -= region_block.block.weight;
+      }
+
+    return other_weights;
+  };
+
+  // the re-cut gives each proc in the region at most (1 + load_balance_factor) times its share of
+  // the region, so this bounds the result of the re-cut without computing it
+  auto isFeasible = [&](const Box& region)
+  {
+    std::map<UInt, double> other_weights = getRegionProcs(region);
+    if (other_weights.size() == 0)
+      return false;
+
+    double region_weight = meshblock->weight * double(getVolume(region)) / prod(meshblock->element_counts);
+    double max_other_weight = 0;
+    for (auto& [proc, weight] : other_weights)
+      max_other_weight = std::max(max_other_weight, weight);
+
+    return max_other_weight + (1 + load_balance_factor) * region_weight / other_weights.size() <= max_weight;
+  };
+
+  // partitions the region as if it were a MeshBlock, and matches the new blocks to the procs
+  // greedily by overlap with the old blocks
+  std::vector<SplitBlock> new_blocks;
+  std::vector<UInt> new_block_procs;
+  auto recut = [&](const Box& region)
+  {
+    std::map<UInt, double> other_weights = getRegionProcs(region);
+    auto region_meshblock = std::make_shared<MeshBlock>(meshblock->block_id, region.hi[0] - region.lo[0], region.hi[1] - region.lo[1],
+                                                        region.hi[2] - region.lo[2],
+                                                        meshblock->weight * double(getVolume(region)) / prod(meshblock->element_counts));
+    PartitionResult partition = partitionMesh({region_meshblock}, other_weights.size(), load_balance_factor, PartitionOptions());
+    new_blocks.clear();
+    for (const std::vector<SplitBlock>& blocks : partition.blocks_on_procs)
+      for (const SplitBlock& block : blocks)
+      {
+        std::array<UInt, 3> mesh_offsets = region.lo;
+        for (UInt d=0; d < 3; ++d)
+          mesh_offsets[d] += block.mesh_offsets[d];
+        new_blocks.emplace_back(meshblock, block.element_counts, mesh_offsets);
+      }
+
+    std::vector<std::tuple<UInt, UInt, UInt>> overlaps;  // overlap, new block, proc
+    for (UInt i=0; i < new_blocks.size(); ++i)
+      for (const RegionBlock& region_block : meshblock_blocks)
+        if (region_block.proc != NoProc && contains(region, getBox(region_block.block)))
+          if (UInt overlap = computeOverlap(new_blocks[i], region_block.block); overlap > 0)
+            overlaps.emplace_back(overlap, i, region_block.proc);
+    std::sort(overlaps.begin(), overlaps.end(), std::greater<std::tuple<UInt, UInt, UInt>>());
+
+    new_block_procs.assign(new_blocks.size(), NoProc);
+    std::unordered_set<UInt> matched_procs;
+    for (auto& [overlap, i, proc] : overlaps)
+      if (new_block_procs[i] == NoProc && !matched_procs.count(proc))
+      {
+        new_block_procs[i] = proc;
+        matched_procs.insert(proc);
+      }
+
+    auto proc_it = other_weights.begin();
+    for (UInt i=0; i < new_blocks.size(); ++i)
+      for (; new_block_procs[i] == NoProc; ++proc_it)
+        if (!matched_procs.count(proc_it->first))
+        {
+          new_block_procs[i] = proc_it->first;
+          matched_procs.insert(proc_it->first);
+        }
+  };
+
+  // grow the region one layer of blocks at a time, in the direction that adds the fewest elements,
+  // until the bound on the re-cut does not overload any proc.  The region is only re-cut once
+  Box whole_meshblock = getBox(SplitBlock(meshblock));
+  Box region = closeRegion(getBox(orphan));
+  while (!isFeasible(region) && getVolume(region) < getVolume(whole_meshblock))
+  {
+    Box best_region = whole_meshblock;
+    for (UInt d=0; d < 3; ++d)
+      for (bool upper : {false, true})
+      {
+        Box candidate = region;
+        if (upper && candidate.hi[d] < whole_meshblock.hi[d])
+          candidate.hi[d]++;
+        else if (!upper && candidate.lo[d] > 0)
+          candidate.lo[d]--;
+        else
+          continue;
+
+        candidate = closeRegion(candidate);
+        if (getVolume(candidate) < getVolume(best_region))
+          best_region = candidate;
+      }
+
+    region = best_region;
+  }
+
+  recut(region);
+
+  std::map<UInt, double> other_weights = getRegionProcs(region);
+
+  // replace the old blocks in the region
+  auto isInRegion = [&](const SplitBlock& block) { return block.meshblock == meshblock && contains(region, getBox(block)); };
+  for (auto& [proc, other_weight] : other_weights)
+  {
+    std::vector<SplitBlock>& blocks = new_blocks_on_procs[proc];
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(), isInRegion), blocks.end());
+    weights_on_procs[proc] = other_weight;
+  }
+
+  for (UInt i=0; i < new_blocks.size(); ++i)
+  {
+    new_blocks_on_procs[new_block_procs[i]].push_back(new_blocks[i]);
+    weights_on_procs[new_block_procs[i]] += new_blocks[i].weight;
+  }
+
+  orphaned_blocks.erase(std::remove_if(orphaned_blocks.begin(), orphaned_blocks.end(), isInRegion), orphaned_blocks.end());
+
+  return getVolume(region);
+}
+
+}
+
+MigrationVolume computeMigrationVolume(const std::vector<std::vector<SplitBlock>>& old_blocks_on_procs,
+                                       const std::vector<std::vector<SplitBlock>>& new_blocks_on_procs)
+{
+  MigrationVolume migrated;
+  for (UInt proc=0; proc < new_blocks_on_procs.size(); ++proc)
+    for (const SplitBlock& block : new_blocks_on_procs[proc])
+    {
+      UInt num_elements = prod(block.element_counts);
+      UInt num_stayed = 0;
+      if (proc < old_blocks_on_procs.size())
+        for (const SplitBlock& old_block : old_blocks_on_procs[proc])
+          if (old_block.meshblock == block.meshblock)
+            num_stayed += computeOverlap(block, old_block);
+
+      migrated.elements += num_elements - num_stayed;
+      migrated.weight   += block.weight * double(num_elements - num_stayed) / num_elements;
+    }
+
+  return migrated;
+}
+
+RepartitionResult repartitionMesh(const std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt new_nprocs,
+                                  double load_balance_factor, bool allow_non_adjacent_siblings)
+{
+  if (new_nprocs == 0)
+    throw std::runtime_error("new_nprocs must be greater than zero");
+
+  std::vector<std::vector<SplitBlock>> new_blocks_on_procs(new_nprocs);
+  std::vector<double> weights_on_procs(new_nprocs, 0.0);
+  std::vector<SplitBlock> orphaned_blocks;
+  double total_weight = 0;
+  for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
+    for (const SplitBlock& block : blocks_on_procs[proc])
+    {
+      total_weight += block.weight;
+      if (proc < new_nprocs)
+      {
+        new_blocks_on_procs[proc].push_back(block);
+        weights_on_procs[proc] += block.weight;
+      } else
+        orphaned_blocks.push_back(block);
+    }
+
+  double max_weight = (1 + load_balance_factor) * total_weight / new_nprocs;
+
+  // remove the smallest blocks from overloaded procs, which moves the least data.  The
+  // last block is left even if it is over the limit, and split below
+  for (UInt proc=0; proc < new_nprocs; ++proc)
+  {
+    std::vector<SplitBlock>& blocks = new_blocks_on_procs[proc];
+    if (weights_on_procs[proc] <= max_weight)
+      continue;
+
+    std::stable_sort(blocks.begin(), blocks.end(), [](const SplitBlock& lhs, const SplitBlock& rhs) { return lhs.weight > rhs.weight; });
+    while (weights_on_procs[proc] > max_weight && blocks.size() > 1)
+    {
+      weights_on_procs[proc] -= blocks.back().weight;
+      orphaned_blocks.push_back(blocks.back());
+      blocks.pop_back();
+    }
+
+    UInt max_dir = getLongestDirection(blocks[0].element_counts);
+    if (weights_on_procs[proc] > max_weight && blocks[0].element_counts[max_dir] > 1)
+    {
+      UInt nelem = std::floor(blocks[0].element_counts[max_dir] * max_weight / blocks[0].weight);
+      auto [block_keep, block_orphan] = splitBlock(blocks[0], static_cast<SplitDirection>(max_dir), std::max(nelem, UInt(1)));
+      blocks[0] = block_keep;
+      weights_on_procs[proc] = block_keep.weight;
+      orphaned_blocks.push_back(block_orphan);
+    }
+  }
+
+  // place the orphaned blocks, largest first, on the least loaded procs that can take them
+  auto compareWeight = [](const SplitBlock& lhs, const SplitBlock& rhs) { return lhs.weight < rhs.weight; };
+  std::make_heap(orphaned_blocks.begin(), orphaned_blocks.end(), compareWeight);
+  RepartitionResult result;
+  while (orphaned_blocks.size() > 0)
+  {
+    std::pop_heap(orphaned_blocks.begin(), orphaned_blocks.end(), compareWeight);
+    SplitBlock block = orphaned_blocks.back();
+    orphaned_blocks.pop_back();
+
+    UInt min_proc = new_nprocs;
+    double min_weight = std::numeric_limits<double>::max();
+    for (UInt proc=0; proc < new_nprocs; ++proc)
+      if (weights_on_procs[proc] < min_weight && canAssignToProc(new_blocks_on_procs[proc], block, allow_non_adjacent_siblings))
+      {
+        min_proc = proc;
+        min_weight = weights_on_procs[proc];
+      }
+
+    if (min_proc == new_nprocs)
+    {
+      result.recut_elements += recutRegion(block, orphaned_blocks, new_blocks_on_procs, weights_on_procs, max_weight, load_balance_factor);
+      result.num_recut_regions++;
+      std::make_heap(orphaned_blocks.begin(), orphaned_blocks.end(), compareWeight);
+      continue;
+    }
+
+    // split off the part that fits.  If the free capacity is less than one layer of elements,
+    // one layer is placed anyway, which bounds the overshoot and the number of splits
+    double capacity = max_weight - min_weight;
+    UInt max_dir = getLongestDirection(block.element_counts);
+    if (block.weight > capacity && block.element_counts[max_dir] > 1)
+    {
+      UInt nelem = std::floor(block.element_counts[max_dir] * std::max(capacity, 0.0) / block.weight);
+      auto [block_fit, block_remainder] = splitBlock(block, static_cast<SplitDirection>(max_dir), std::max(nelem, UInt(1)));
+      orphaned_blocks.push_back(block_remainder);
+      std::push_heap(orphaned_blocks.begin(), orphaned_blocks.end(), compareWeight);
+      block = block_fit;
+    }
+
+    new_blocks_on_procs[min_proc].push_back(block);
+    weights_on_procs[min_proc] += block.weight;
+  }
+
+  result.blocks_on_procs = std::move(new_blocks_on_procs);
+  result.imbalance = computeImbalance(weights_on_procs);
+
+  // the re-cut regions can only take load from procs that own part of the same MeshBlock, so
+  // if that was not enough, partition from scratch
+  PartitionStatus unbalanced_status = PartitionStatus::Unbalanced;
+  if (result.imbalance > load_balance_factor)
+  {
+    PartitionResult partition = partitionFromScratch(blocks_on_procs, new_nprocs, load_balance_factor, allow_non_adjacent_siblings);
+    if (partition.imbalance < result.imbalance)
+    {
+      result.blocks_on_procs = std::move(partition.blocks_on_procs);
+      result.imbalance = partition.imbalance;
+      result.partitioned_from_scratch = true;
+      unbalanced_status = partition.status;
+    }
+  }
+
+  result.status = result.imbalance <= load_balance_factor ? PartitionStatus::Balanced : unbalanced_status;
+  result.migrated = computeMigrationVolume(blocks_on_procs, result.blocks_on_procs);
+
+  return result;
+}
+
+}
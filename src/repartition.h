@@ -0,0 +1,55 @@
+#ifndef STRUCTURED_PART_REPARTITION_H
+#define STRUCTURED_PART_REPARTITION_H
+
+#include "blocks.h"
+#include "partition_options.h"
+#include <vector>
+
+namespace structured_part {
+
+// amount of the mesh that is on a different proc in one decomposition than in another
+struct MigrationVolume
+{
+  UInt elements = 0;
+  double weight = 0;
+};
+
+// computes the elements of new_blocks_on_procs that were not on the same proc in
+// old_blocks_on_procs.  Procs that do not exist in old_blocks_on_procs have no elements.
+// Both decompositions must be of the same MeshBlocks
+MigrationVolume computeMigrationVolume(const std::vector<std::vector<SplitBlock>>& old_blocks_on_procs,
+                                       const std::vector<std::vector<SplitBlock>>& new_blocks_on_procs);
+
+struct RepartitionResult
+{
+  std::vector<std::vector<SplitBlock>> blocks_on_procs;
+  PartitionStatus status;  // Balanced, Unbalanced, or the status of the partition from scratch
+  double imbalance;
+  MigrationVolume migrated;
+
+  // number of regions of MeshBlocks that were re-cut because every proc had a sibling of an
+  // orphaned block, and the number of elements in them.  A region may be a whole MeshBlock
+  UInt num_recut_regions = 0;
+  UInt recut_elements = 0;
+
+  // true if the re-cut regions could not be balanced, and the mesh was partitioned from scratch
+  // with the new procs numbered to keep as much of the old decomposition as possible
+  bool partitioned_from_scratch = false;
+};
+
+// computes a decomposition onto new_nprocs procs that is close to blocks_on_procs, for when the
+// number of procs changes (node failure, resizing a malleable job).  When shrinking, the blocks on
+// procs >= new_nprocs are orphaned.  The orphaned blocks, and the smallest blocks of procs that are
+// over (1 + load_balance_factor) times the new average weight, are moved to the least loaded procs
+// that can take them, and only blocks that do not fit anywhere are split.  Procs that are not
+// orphaned or overloaded keep their blocks.  If the sibling rule (see assignBlocksToProcs) leaves
+// no proc that can take a block, the smallest box of whole blocks of its MeshBlock around it
+// that the procs owning those blocks can absorb is re-cut into one block per proc, and the new
+// blocks are given to the procs whose old blocks they overlap most.  If the result is still not
+// balanced, the mesh is partitioned from scratch (see RepartitionResult::partitioned_from_scratch)
+RepartitionResult repartitionMesh(const std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt new_nprocs,
+                                  double load_balance_factor, bool allow_non_adjacent_siblings=false);
+
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "statistics.h"
+#include <algorithm>
 #include <iomanip>
 #include <cmath>
 
@@ -7,6 +8,45 @@
 
 namespace structured_part {
 
+double computeAspectRatio(const SplitBlock& block)
+{
+  UInt dim = getDimension(block.meshblock->element_counts);
+  UInt min_count = block.element_counts[0], max_count = block.element_counts[0];
+  for (UInt d=1; d < dim; ++d)
+  {
+    min_count = std::min(min_count, block.element_counts[d]);
+    max_count = std::max(max_count, block.element_counts[d]);
+  }
+
+  return double(max_count) / min_count;
+}
+
+UInt computeCutSurface(const std::vector<std::vector<SplitBlock>>& blocks_per_proc)
+{
+  // count the faces of each block that are not on the surface of its MeshBlock.  Every cut face
+  // is on the surface of two blocks.  This is done per block rather than by subtracting the
+  // surface area of the MeshBlocks from the total so it cannot underflow when the blocks do not
+  // cover their MeshBlocks
+  UInt cut_area = 0;
+  for (const std::vector<SplitBlock>& blocks : blocks_per_proc)
+    for (const SplitBlock& block : blocks)
+    {
+      const std::array<UInt, 3>& meshblock_counts = block.meshblock->element_counts;
+      UInt num_elements = prod(block.element_counts);
+      for (UInt d=0; d < getDimension(meshblock_counts); ++d)
+      {
+        UInt face_area = num_elements / block.element_counts[d];
+        if (block.mesh_offsets[d] > 0)
+          cut_area += face_area;
+
+        if (block.mesh_offsets[d] + block.element_counts[d] < meshblock_counts[d])
+          cut_area += face_area;
+      }
+    }
+
+  return cut_area / 2;
+}
+
 DecompStats computeDecompStats(const std::vector<std::vector<SplitBlock>>& blocks_per_proc)
 {
   UInt nprocs = blocks_per_proc.size();
@@ -29,10 +69,33 @@ DecompStats computeDecompStats(const std::vector<std::vector<SplitBlock>>& block
     stats.min_blocks_per_proc = std::min(stats.min_blocks_per_proc, num_blocks_on_proc);
     stats.avg_blocks_per_proc += num_blocks_on_proc;
 
+    for (const SplitBlock& block : blocks_per_proc[proc])
+      stats.max_aspect_ratio = std::max(stats.max_aspect_ratio, computeAspectRatio(block));
   }
 
   stats.avg_weight_per_process /= nprocs;
   stats.avg_blocks_per_proc /= nprocs;
+  stats.cut_surface = computeCutSurface(blocks_per_proc);
+
+  return stats;
+}
+
+DecompStats computeDecompStats(const std::vector<std::vector<SplitBlock>>& blocks_per_proc, const CostModel& cost_model)
+{
+  DecompStats stats = computeDecompStats(blocks_per_proc);
+
+  stats.has_cost = true;
+  for (const std::vector<SplitBlock>& blocks : blocks_per_proc)
+  {
+    double cost = computeTotalCost(blocks, cost_model);
+
+    stats.min_cost = std::min(stats.min_cost, cost);
+    stats.max_cost = std::max(stats.max_cost, cost);
+    stats.avg_cost_per_process += cost;
+    stats.cost_per_process.push_back(cost);
+  }
+
+  stats.avg_cost_per_process /= blocks_per_proc.size();
 
   return stats;
 }
@@ -42,11 +105,89 @@ std::ostream& operator<<(std::ostream& os, const DecompStats& stats)
   os << "decomp with " << stats.num_blocks << " sub-blocks" << std::endl;
   os << "min, max, avg weight = " << stats.min_weight << ", " << stats.max_weight << ", " << stats.avg_weight_per_process << std::endl;
   os << "min, max, avg blocks per proc " << stats.min_blocks_per_proc << ", " << stats.max_blocks_per_proc << ", " << stats.avg_blocks_per_proc << std::endl;
+  os << "cut surface = " << stats.cut_surface << ", max aspect ratio = " << stats.max_aspect_ratio << std::endl;
   os << "max load imbalance overage % = " << 100 * (stats.max_weight - stats.avg_weight_per_process)/stats.avg_weight_per_process;
+  if (stats.has_cost)
+  {
+    os << std::endl << "min, max, avg modeled cost = " << stats.min_cost << ", " << stats.max_cost << ", " << stats.avg_cost_per_process << std::endl;
+    os << "max modeled cost imbalance overage % = " << 100 * (stats.max_cost - stats.avg_cost_per_process)/stats.avg_cost_per_process;
+  }
 
   return os;
 }
 
+MemoryStats computeMemoryStats(const std::vector<std::vector<SplitBlock>>& blocks_per_proc, const MemoryModel& memory_model,
+                               UInt num_bins)
+{
+  if (num_bins == 0)
+    throw std::runtime_error("num_bins must be greater than zero");
+
+  UInt nprocs = blocks_per_proc.size();
+  MemoryStats stats;
+  stats.histogram.resize(num_bins, 0);
+  if (nprocs == 0)
+  {
+    stats.min_memory = 0.0;
+    return stats;
+  }
+
+  for (UInt proc=0; proc < nprocs; ++proc)
+  {
+    UInt num_cells = 0;
+    for (const SplitBlock& block : blocks_per_proc[proc])
+      num_cells += computeAllocatedCells(block, memory_model.ghost_width, memory_model.ghosts_on_mesh_boundary);
+
+    double memory = computeTotalMemory(blocks_per_proc[proc], memory_model);
+    stats.min_memory = std::min(stats.min_memory, memory);
+    if (memory > stats.max_memory)
+    {
+      stats.max_memory = memory;
+      stats.max_memory_proc = proc;
+    }
+    stats.avg_memory_per_process += memory;
+    stats.memory_per_process.push_back(memory);
+    stats.allocated_cells_per_process.push_back(num_cells);
+  }
+
+  stats.avg_memory_per_process /= nprocs;
+
+  stats.histogram_bin_width = (stats.max_memory - stats.min_memory) / num_bins;
+  for (double memory : stats.memory_per_process)
+  {
+    UInt bin = stats.histogram_bin_width > 0 ? UInt((memory - stats.min_memory) / stats.histogram_bin_width) : 0;
+    stats.histogram[std::min(bin, num_bins - 1)]++;
+  }
+
+  return stats;
+}
+
+std::ostream& operator<<(std::ostream& os, const MemoryStats& stats)
+{
+  if (stats.max_memory_proc >= stats.allocated_cells_per_process.size())
+    return os << "no processes";
+
+  os << "min, max, avg memory = " << stats.min_memory << ", " << stats.max_memory << ", " << stats.avg_memory_per_process << std::endl;
+  os << "max memory on rank " << stats.max_memory_proc << ", with " << stats.allocated_cells_per_process[stats.max_memory_proc]
+     << " allocated cells";
+
+  return os;
+}
+
+void printHistogram(std::ostream& os, const MemoryStats& stats, UInt width)
+{
+  if (stats.memory_per_process.empty())
+    return;
+
+  UInt max_count = *std::max_element(stats.histogram.begin(), stats.histogram.end());
+  for (UInt bin=0; bin < stats.histogram.size(); ++bin)
+  {
+    UInt num_chars = std::round(width * stats.histogram[bin] / double(max_count));
+    std::string str(num_chars, '#');
+    os << std::setw(12) << stats.min_memory + bin * stats.histogram_bin_width << ": " << std::setw(6) << stats.histogram[bin]
+       << " " << str << "\n";
+  }
+}
+
 void printPerProcessStats(std::ostream& os, const DecompStats& stats)
 {
   os << "weights per process, num_blocks = " << std::endl;
@@ -2,6 +2,8 @@
 #define STRUCTURED_PART_STATS_H
 
 #include "blocks.h"
+#include "cost_model.h"
+#include "memory_model.h"
 #include <limits>
 
 namespace structured_part {
@@ -18,12 +20,59 @@ struct DecompStats
   double max_weight = std::numeric_limits<double>::min();
   double avg_weight_per_process = 0.0;
   std::vector<double> weight_per_process;
+
+  // modeled cost (see CostModel), only computed if a CostModel is given
+  bool has_cost = false;
+  double min_cost = std::numeric_limits<double>::max();
+  double max_cost = std::numeric_limits<double>::min();
+  double avg_cost_per_process = 0.0;
+  std::vector<double> cost_per_process;
+
+  // number of element faces between sub-blocks of the same MeshBlock, see computeCutSurface
+  UInt cut_surface = 0;
+  double max_aspect_ratio = 0.0;
 };
 
+// returns the ratio of the largest to the smallest number of elements of the block in each
+// direction (only i and j for 2D blocks)
+double computeAspectRatio(const SplitBlock& block);
+
+// returns the number of element faces created by splitting the MeshBlocks into blocks_per_proc.
+// If the blocks do not cover their MeshBlocks, a face between a block and an uncovered part of
+// the MeshBlock counts as half a face
+UInt computeCutSurface(const std::vector<std::vector<SplitBlock>>& blocks_per_proc);
+
 DecompStats computeDecompStats(const std::vector<std::vector<SplitBlock>>& blocks_per_proc);
 
+// same as above, but also computes the modeled cost of each process
+DecompStats computeDecompStats(const std::vector<std::vector<SplitBlock>>& blocks_per_proc, const CostModel& cost_model);
+
 std::ostream& operator<<(std::ostream& os, const DecompStats& stats);
 
+// estimated memory of each process, see MemoryModel
+struct MemoryStats
+{
+  double min_memory = std::numeric_limits<double>::max();
+  double max_memory = 0.0;
+  double avg_memory_per_process = 0.0;
+  UInt max_memory_proc = 0;
+  std::vector<double> memory_per_process;
+  std::vector<UInt> allocated_cells_per_process;
+
+  // histogram[i] is the number of processes with memory in
+  // [min_memory + i * histogram_bin_width, min_memory + (i + 1) * histogram_bin_width).  The
+  // last bin also includes max_memory
+  double histogram_bin_width = 0.0;
+  std::vector<UInt> histogram;
+};
+
+MemoryStats computeMemoryStats(const std::vector<std::vector<SplitBlock>>& blocks_per_proc, const MemoryModel& memory_model,
+                               UInt num_bins=10);
+
+std::ostream& operator<<(std::ostream& os, const MemoryStats& stats);
+
+void printHistogram(std::ostream& os, const MemoryStats& stats, UInt width=64);
+
 void printPerProcessStats(std::ostream& os, const DecompStats& stats);
 
 void printHistogram(std::ostream& os, const DecompStats& stats, UInt width=64);
@@ -1,12 +1,125 @@
 #include "structured_part.h"
 #include "final_split.h"
+#include "recursive_bisection.h"
+#include "validate.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 
 
 namespace structured_part {
 
 std::vector<std::vector<SplitBlock>> partitionMesh(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor)
 {
-  return finalSplit(mesh_blocks, nprocs, load_balance_factor);
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = finalSplit(mesh_blocks, nprocs, load_balance_factor);
+#ifndef NDEBUG
+  validateDecomposition(mesh_blocks, blocks_on_procs);
+#endif
+
+  return blocks_on_procs;
+}
+
+PartitionResult partitionMesh(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                              const PartitionOptions& options)
+{
+  PartitionResult result = options.engine == PartitionEngine::RecursiveBisection ?
+                             recursiveBisection(mesh_blocks, nprocs, load_balance_factor, options) :
+                             finalSplit(mesh_blocks, nprocs, load_balance_factor, options);
+#ifndef NDEBUG
+  validateDecomposition(mesh_blocks, result.blocks_on_procs, options.allow_non_adjacent_siblings);
+#endif
+
+  return result;
+}
+
+std::vector<PartitionResult> partitionMeshes(const std::vector<PartitionProblem>& problems, UInt nthreads)
+{
+  UInt num_problems = problems.size();
+  if (nthreads == 0)
+    nthreads = std::max(std::thread::hardware_concurrency(), 1U);
+  nthreads = std::max(std::min(nthreads, num_problems), UInt(1));
+
+  // the cost grows with nprocs, so start with the largest to balance the work between threads
+  std::vector<UInt> order(num_problems);
+  for (UInt i=0; i < num_problems; ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](UInt lhs, UInt rhs) { return problems[lhs].nprocs > problems[rhs].nprocs; });
+
+  std::vector<PartitionResult> results(num_problems);
+  std::vector<std::exception_ptr> exceptions(num_problems);
+  std::atomic<UInt> next_problem(0);
+  auto worker = [&]()
+  {
+    for (UInt i = next_problem++; i < num_problems; i = next_problem++)
+    {
+      const PartitionProblem& problem = problems[order[i]];
+      try
+      {
+        results[order[i]] = partitionMesh(problem.mesh_blocks, problem.nprocs, problem.load_balance_factor, problem.options);
+      } catch (...)
+      {
+        exceptions[order[i]] = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (UInt i=1; i < nthreads; ++i)
+    threads.emplace_back(worker);
+  worker();
+
+  for (std::thread& thread : threads)
+    thread.join();
+
+  for (std::exception_ptr& exception : exceptions)
+    if (exception)
+      std::rethrow_exception(exception);
+
+  return results;
+}
+
+void partitionMesh(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                   const BlockSink& sink)
+{
+  streamBlockAssignments(partitionMesh(mesh_blocks, nprocs, load_balance_factor), sink);
 }
 
-}
\ No newline at end of file
+PartitionResult partitionMesh(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                              const PartitionOptions& options, const BlockSink& sink)
+{
+  if (options.engine == PartitionEngine::RecursiveBisection)
+  {
+    auto proc_sink = [&](UInt proc, std::vector<SplitBlock>&& blocks)
+    {
+      for (const SplitBlock& block : blocks)
+        sink(proc, block);
+    };
+
+    return recursiveBisection(mesh_blocks, nprocs, load_balance_factor, options, proc_sink);
+  }
+
+  // the final split can move blocks between any procs until the last iteration, so no proc is
+  // finished before the whole decomposition is
+  PartitionResult result = partitionMesh(mesh_blocks, nprocs, load_balance_factor, options);
+  streamBlockAssignments(std::move(result.blocks_on_procs), sink);
+  result.blocks_on_procs.clear();
+
+  return result;
+}
+
+void streamBlockAssignments(std::vector<std::vector<SplitBlock>>&& blocks_on_procs, const BlockSink& sink)
+{
+  for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
+  {
+    for (const SplitBlock& split_block : blocks_on_procs[proc])
+      sink(proc, split_block);
+
+    std::vector<SplitBlock>().swap(blocks_on_procs[proc]);
+  }
+
+  std::vector<std::vector<SplitBlock>>().swap(blocks_on_procs);
+}
+
+}
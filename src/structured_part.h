@@ -2,11 +2,101 @@
 #define STRUCTURED_PART_STRUCTURED_PART_H
 
 #include "blocks.h"
+#include "partition_options.h"
+#include <functional>
+#include <vector>
 
 namespace structured_part {
 
+// All functions in this library are reentrant: they do not write to std::cout or modify global
+// state, so they can be called from several threads at once, as long as the threads do not modify
+// the MeshBlocks while they are being partitioned
+
 std::vector<std::vector<SplitBlock>> partitionMesh(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor);
 
+// same as above, but stops when the budget in options runs out, or when no block can be split
+// further, and returns the best decomposition found rather than throwing.  The result records
+// why the partitioner stopped and the imbalance achieved
+PartitionResult partitionMesh(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                              const PartitionOptions& options);
+
+struct PartitionProblem
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks;
+  UInt nprocs;
+  double load_balance_factor;
+  PartitionOptions options;
+};
+
+// partitions each of the independent problems on a pool of nthreads threads (0 means one per hardware
+// thread), and returns the results in the same order as problems.  Idle threads take the next
+// problem, largest number of procs first, so a few large problems do not leave threads waiting at the
+// end.  If any problem throws, the exception of the first such problem is rethrown after all the
+// problems have finished
+std::vector<PartitionResult> partitionMeshes(const std::vector<PartitionProblem>& problems, UInt nthreads=0);
+
+// receives the blocks of a decomposition one at a time.  All the blocks of rank 0 are
+// passed first, then all the blocks of rank 1, etc.
+using BlockSink = std::function<void(UInt rank, const SplitBlock& block)>;
+
+struct RankBlock
+{
+  UInt rank;
+  SplitBlock block;
+};
+
+// same as above, but passes the blocks to sink rather than returning them.  The decomposition
+// is still computed in full before the first block is passed to the sink, so this does not reduce
+// the peak memory of partitioning, it only saves the caller from copying the blocks out of the
+// nested vector
+void partitionMesh(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                   const BlockSink& sink);
+
+// same as above, but with options (see the PartitionOptions overload of partitionMesh).  The
+// blocks_on_procs of the result is empty, because the blocks were passed to the sink.  With
+// PartitionEngine::RecursiveBisection, the blocks of each rank are passed as soon as the rank is
+// finished, and the whole decomposition is never held (see recursiveBisection), but the
+// bisection runs on one thread.  With PartitionEngine::SplitAndAssign, the decomposition is
+// computed in full first, as above
+PartitionResult partitionMesh(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                              const PartitionOptions& options, const BlockSink& sink);
+
+// same as above, but writes a RankBlock for each block to the output iterator out.
+// Returns the iterator past the last element written
+template <typename OutputIt>
+OutputIt partitionMeshTo(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs, double load_balance_factor,
+                         OutputIt out)
+{
+  auto sink = [&](UInt rank, const SplitBlock& block)
+  {
+    *out = RankBlock{rank, block};
+    ++out;
+  };
+  partitionMesh(mesh_blocks, nprocs, load_balance_factor, BlockSink(sink));
+
+  return out;
+}
+
+// same as above, but with options.  Returns the result (with an empty blocks_on_procs) and the
+// iterator past the last element written
+template <typename OutputIt>
+std::pair<PartitionResult, OutputIt> partitionMeshTo(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs,
+                                                     double load_balance_factor, const PartitionOptions& options, OutputIt out)
+{
+  auto sink = [&](UInt rank, const SplitBlock& block)
+  {
+    *out = RankBlock{rank, block};
+    ++out;
+  };
+  PartitionResult result = partitionMesh(mesh_blocks, nprocs, load_balance_factor, options, BlockSink(sink));
+
+  return {std::move(result), out};
+}
+
+// passes blocks_on_procs to the sink, releasing the memory for each rank after its blocks
+// have been passed
+void streamBlockAssignments(std::vector<std::vector<SplitBlock>>&& blocks_on_procs, const BlockSink& sink);
+
 }
 
 #endif
@@ -0,0 +1,73 @@
+#include "sweep.h"
+#include "final_split.h"
+#include "pre_split.h"
+#include "recursive_bisection.h"
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+namespace structured_part {
+
+std::vector<SweepResult> partitionMeshSweep(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs_min, UInt nprocs_max,
+                                            double load_balance_factor, const PartitionOptions& options, UInt nthreads)
+{
+  if (nprocs_min == 0 || nprocs_max < nprocs_min)
+    throw std::runtime_error("invalid range of nprocs");
+
+  UInt num_cases = nprocs_max - nprocs_min + 1;
+  if (nthreads == 0)
+    nthreads = std::max(std::thread::hardware_concurrency(), 1U);
+  nthreads = std::min(nthreads, num_cases);
+
+  SplitCache cache;
+  std::vector<SweepResult> results(num_cases);
+  std::vector<std::exception_ptr> exceptions(num_cases);
+
+  // the cost grows with nprocs, so start with the largest to balance the work between threads
+  std::atomic<UInt> next_case(0);
+  auto worker = [&]()
+  {
+    for (UInt i = next_case++; i < num_cases; i = next_case++)
+    {
+      UInt idx = num_cases - i - 1;
+      try
+      {
+        UInt nprocs = nprocs_min + idx;
+        PartitionResult result = options.engine == PartitionEngine::RecursiveBisection ?
+                                   recursiveBisection(mesh_blocks, nprocs, load_balance_factor, options) :
+                                   finalSplit(mesh_blocks, nprocs, load_balance_factor, options, cache);
+        results[idx].status = result.status;
+        results[idx].imbalance = result.imbalance;
+        results[idx].stats = options.cost_model.isWeightOnly() ? computeDecompStats(result.blocks_on_procs) :
+                                                                 computeDecompStats(result.blocks_on_procs, options.cost_model);
+      } catch (...)
+      {
+        // only invalid options throw, which is the same for every number of procs
+        exceptions[idx] = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (UInt i=1; i < nthreads; ++i)
+    threads.emplace_back(worker);
+  worker();
+
+  for (std::thread& thread : threads)
+    thread.join();
+
+  for (std::exception_ptr& exception : exceptions)
+    if (exception)
+      std::rethrow_exception(exception);
+
+  return results;
+}
+
+std::vector<SweepResult> partitionMeshSweep(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs_min, UInt nprocs_max,
+                                            double load_balance_factor, UInt nthreads)
+{
+  return partitionMeshSweep(mesh_blocks, nprocs_min, nprocs_max, load_balance_factor, PartitionOptions(), nthreads);
+}
+
+}
@@ -0,0 +1,35 @@
+#ifndef STRUCTURED_PART_SWEEP_H
+#define STRUCTURED_PART_SWEEP_H
+
+#include "blocks.h"
+#include "partition_options.h"
+#include "statistics.h"
+#include <vector>
+
+namespace structured_part {
+
+// the outcome of partitioning for one number of procs of a sweep
+struct SweepResult
+{
+  PartitionStatus status = PartitionStatus::Balanced;
+  double imbalance = 0.0;
+  DecompStats stats;
+};
+
+// partitions the mesh for every number of procs in [nprocs_min, nprocs_max] and returns the
+// status, imbalance and DecompStats of each (entry i is for nprocs_min + i).  A number of procs
+// that cannot be balanced does not stop the sweep, its status says why.  With the
+// SplitAndAssign engine, the splits of each MeshBlock into a given number of sub-blocks are
+// computed once and shared between the numbers of procs.  The number of sub-blocks of each
+// MeshBlock is computed separately for each number of procs.  The numbers of procs are
+// partitioned in parallel on nthreads threads (0 means one per hardware thread)
+std::vector<SweepResult> partitionMeshSweep(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs_min, UInt nprocs_max,
+                                            double load_balance_factor, const PartitionOptions& options, UInt nthreads=0);
+
+// same as above, with the default PartitionOptions
+std::vector<SweepResult> partitionMeshSweep(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks, UInt nprocs_min, UInt nprocs_max,
+                                            double load_balance_factor, UInt nthreads=0);
+
+}
+
+#endif
@@ -0,0 +1,126 @@
+#include "thread_split.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace structured_part {
+
+namespace {
+
+// appends the elements [begin, end) of block, numbered in memory order (with k varying fastest),
+// as at most five tiles: the rest of a row, the rest of a plane, whole planes, whole rows and
+// part of a row
+void appendRun(const SplitBlock& block, UInt begin, UInt end, std::vector<SplitBlock>& tiles)
+{
+  const std::array<UInt, 3>& counts = block.element_counts;
+  UInt row_size = counts[2], plane_size = counts[1] * counts[2];
+  while (begin < end)
+  {
+    std::array<UInt, 3> idx = {begin / plane_size, (begin % plane_size) / row_size, begin % row_size};
+    std::array<UInt, 3> tile_counts;
+    if (idx[2] != 0 || end - begin < row_size)
+      tile_counts = {1, 1, std::min(row_size - idx[2], end - begin)};
+    else if (idx[1] != 0 || end - begin < plane_size)
+      tile_counts = {1, std::min(counts[1] - idx[1], (end - begin) / row_size), row_size};
+    else
+      tile_counts = {(end - begin) / plane_size, counts[1], row_size};
+
+    std::array<UInt, 3> offsets = block.mesh_offsets;
+    for (UInt d=0; d < 3; ++d)
+      offsets[d] += idx[d];
+
+    tiles.emplace_back(block.meshblock, tile_counts, offsets);
+    begin += prod(tile_counts);
+  }
+}
+
+// returns the element of block to end a run at, given the ideal (fractional) position.  The
+// first of the nearest plane, row and element boundaries within max_error elements is used
+UInt getRunEnd(const SplitBlock& block, double position, double max_error)
+{
+  const std::array<UInt, 3>& counts = block.element_counts;
+  UInt num_elements = prod(counts);
+  for (UInt boundary_size : {counts[1] * counts[2], counts[2], UInt(1)})
+  {
+    UInt end = std::min(UInt(std::round(position / boundary_size)) * boundary_size, num_elements);
+    if (std::abs(end - position) <= max_error || boundary_size == 1)
+      return end;
+  }
+
+  return num_elements;
+}
+
+}
+
+ThreadTiles splitIntoThreadTiles(const std::vector<SplitBlock>& blocks_on_proc, UInt nthreads, double load_balance_factor)
+{
+  if (nthreads == 0)
+    throw std::runtime_error("number of threads must be greater than zero");
+
+  ThreadTiles result;
+  result.tiles_on_threads.resize(nthreads);
+  double total_weight = 0.0;
+  for (const SplitBlock& block : blocks_on_proc)
+    total_weight += block.weight;
+
+  if (total_weight == 0)
+  {
+    for (const SplitBlock& block : blocks_on_proc)
+      result.tiles_on_threads[0].push_back(block);
+
+    return result;
+  }
+
+  // each end of a run may be off by half the slack
+  double avg_weight_per_thread = total_weight / nthreads;
+  double max_weight_error = avg_weight_per_thread * load_balance_factor / 2;
+
+  // the run of thread ends where the weight of the blocks before it reaches (thread + 1) times
+  // the average
+  UInt thread = 0;
+  double weight_before_block = 0.0;
+  std::vector<double> weights_on_threads(nthreads, 0.0);
+  for (const SplitBlock& block : blocks_on_proc)
+  {
+    UInt num_elements = prod(block.element_counts);
+    double element_weight = block.weight / num_elements;
+    UInt begin = 0;
+    while (begin < num_elements)
+    {
+      UInt end = num_elements;
+      if (thread < nthreads - 1)
+      {
+        double position = ((thread + 1) * avg_weight_per_thread - weight_before_block) / element_weight;
+        if (position < num_elements)
+          end = std::max(getRunEnd(block, position, max_weight_error / element_weight), begin);
+      }
+
+      appendRun(block, begin, end, result.tiles_on_threads[thread]);
+      weights_on_threads[thread] += (end - begin) * element_weight;
+      if (end < num_elements)
+        thread++;
+
+      begin = end;
+    }
+
+    weight_before_block += block.weight;
+  }
+
+  double max_weight = *std::max_element(weights_on_threads.begin(), weights_on_threads.end());
+  result.imbalance = max_weight / avg_weight_per_thread - 1;
+  result.status = result.imbalance <= load_balance_factor ? PartitionStatus::Balanced : PartitionStatus::NoSplittableBlock;
+
+  return result;
+}
+
+std::vector<ThreadTiles> splitIntoThreadTiles(const std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt nthreads,
+                                              double load_balance_factor)
+{
+  std::vector<ThreadTiles> tiles_on_procs;
+  for (const std::vector<SplitBlock>& blocks_on_proc : blocks_on_procs)
+    tiles_on_procs.push_back(splitIntoThreadTiles(blocks_on_proc, nthreads, load_balance_factor));
+
+  return tiles_on_procs;
+}
+
+}
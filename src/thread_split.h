@@ -0,0 +1,39 @@
+#ifndef STRUCTURED_PART_THREAD_SPLIT_H
+#define STRUCTURED_PART_THREAD_SPLIT_H
+
+#include "blocks.h"
+#include "partition_options.h"
+#include <vector>
+
+namespace structured_part {
+
+struct ThreadTiles
+{
+  // entry i contains the tiles for thread i
+  std::vector<std::vector<SplitBlock>> tiles_on_threads;
+
+  // Balanced, or NoSplittableBlock if an element is heavier than the load balance factor allows
+  PartitionStatus status = PartitionStatus::Balanced;
+  double imbalance = 0.0;  // max weight per thread / average weight per thread - 1
+};
+
+// Second level of a hybrid decomposition: splits the blocks assigned to a single rank
+// into tiles for nthreads threads, such that no thread has more than
+// (1 + load_balance_factor) times the average work.
+// The elements of the blocks are ordered by block and then by their position in memory
+// (with k varying fastest), and each thread gets one contiguous run of this order, so
+// consecutive threads (which are usually on the same NUMA domain) work on consecutive
+// regions of memory.  The run of a thread is split into at most five tiles per block.
+// The ends of the runs are moved to whole planes (or rows) of elements where that keeps
+// each thread within half the load balance factor, which makes the tiles larger.
+// The tiles have the same meshblock as the SplitBlock they were split from and their
+// mesh_offsets are relative to the MeshBlock.
+ThreadTiles splitIntoThreadTiles(const std::vector<SplitBlock>& blocks_on_proc, UInt nthreads, double load_balance_factor);
+
+// applies the above to every rank
+std::vector<ThreadTiles> splitIntoThreadTiles(const std::vector<std::vector<SplitBlock>>& blocks_on_procs, UInt nthreads,
+                                              double load_balance_factor);
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include "validate.h"
+#include "adjacency.h"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+namespace structured_part {
+
+namespace {
+
+// A set of boxes tiles a box exactly if and only if the signed corner counts of the boxes sum to
+// those of the box.  The sign of a corner is -1 to the power of the number of upper coordinates.
+// This works because the number of boxes covering element x is the sum of the signs of the
+// corners <= x (in every direction), so equal corner sums imply equal coverage everywhere
+struct Corner
+{
+  UInt meshblock_idx;
+  std::array<UInt, 3> coords;
+  int sign;
+};
+
+bool operator<(const Corner& lhs, const Corner& rhs)
+{
+  if (lhs.meshblock_idx != rhs.meshblock_idx)
+    return lhs.meshblock_idx < rhs.meshblock_idx;
+
+  return lhs.coords < rhs.coords;
+}
+
+void addCorners(UInt meshblock_idx, const std::array<UInt, 3>& offsets, const std::array<UInt, 3>& counts, int sign,
+                std::vector<Corner>& corners)
+{
+  for (UInt corner=0; corner < 8; ++corner)
+  {
+    std::array<UInt, 3> coords = offsets;
+    int corner_sign = sign;
+    for (UInt d=0; d < 3; ++d)
+      if (corner & (1 << d))
+      {
+        coords[d] += counts[d];
+        corner_sign = -corner_sign;
+      }
+
+    corners.push_back({meshblock_idx, coords, corner_sign});
+  }
+}
+
+[[noreturn]] void throwInvalid(const std::string& msg)
+{
+  throw std::runtime_error("invalid decomposition: " + msg);
+}
+
+void checkBlockInBounds(UInt proc, const SplitBlock& block)
+{
+  for (UInt d=0; d < 3; ++d)
+    if (block.element_counts[d] == 0 || block.mesh_offsets[d] + block.element_counts[d] > block.meshblock->element_counts[d])
+    {
+      std::stringstream ss;
+      ss << "block on proc " << proc << " with dim = " << block.element_counts << " and offset = " << block.mesh_offsets
+         << " is empty or outside of MeshBlock " << block.meshblock->block_id;
+      throwInvalid(ss.str());
+    }
+}
+
+void checkSiblings(UInt proc, const std::vector<SplitBlock>& blocks_on_proc, bool allow_non_adjacent_siblings)
+{
+  // blocks_on_proc is usually small, so sort pointers to find siblings
+  std::vector<const SplitBlock*> blocks;
+  for (const SplitBlock& block : blocks_on_proc)
+    blocks.push_back(&block);
+
+  auto byMeshBlock = [](const SplitBlock* lhs, const SplitBlock* rhs) { return lhs->meshblock < rhs->meshblock; };
+  std::sort(blocks.begin(), blocks.end(), byMeshBlock);
+
+  for (UInt start=0, end=0; start < blocks.size(); start = end)
+  {
+    for (end = start + 1; end < blocks.size() && blocks[end]->meshblock == blocks[start]->meshblock; ++end) {}
+
+    for (UInt i=start; i < end; ++i)
+      for (UInt j=i+1; j < end; ++j)
+        if (!allow_non_adjacent_siblings || areFaceAdjacent(*blocks[i], *blocks[j]))
+          throwInvalid("proc " + std::to_string(proc) + " has more than one block of MeshBlock " +
+                       std::to_string(blocks[start]->meshblock->block_id));
+  }
+}
+
+}
+
+void validateDecomposition(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks,
+                           const std::vector<std::vector<SplitBlock>>& blocks_on_procs,
+                           bool allow_non_adjacent_siblings)
+{
+  std::unordered_map<const MeshBlock*, UInt> meshblock_idxs;
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+    meshblock_idxs[mesh_blocks[i].get()] = i;
+
+  std::vector<Corner> corners;
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+    addCorners(i, {0, 0, 0}, mesh_blocks[i]->element_counts, -1, corners);
+
+  for (UInt proc=0; proc < blocks_on_procs.size(); ++proc)
+  {
+    for (const SplitBlock& block : blocks_on_procs[proc])
+    {
+      auto it = meshblock_idxs.find(block.meshblock.get());
+      if (it == meshblock_idxs.end())
+        throwInvalid("block on proc " + std::to_string(proc) + " has a MeshBlock that is not in the mesh");
+
+      checkBlockInBounds(proc, block);
+      addCorners(it->second, block.mesh_offsets, block.element_counts, 1, corners);
+    }
+
+    checkSiblings(proc, blocks_on_procs[proc], allow_non_adjacent_siblings);
+  }
+
+  std::sort(corners.begin(), corners.end());
+  for (UInt start=0, end=0; start < corners.size(); start = end)
+  {
+    int sign_sum = 0;
+    for (end = start; end < corners.size() && !(corners[start] < corners[end]); ++end)
+      sign_sum += corners[end].sign;
+
+    if (sign_sum != 0)
+    {
+      std::stringstream ss;
+      ss << "blocks of MeshBlock " << mesh_blocks[corners[start].meshblock_idx]->block_id
+         << " have a gap or overlap at corner " << corners[start].coords;
+      throwInvalid(ss.str());
+    }
+  }
+}
+
+}
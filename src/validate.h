@@ -0,0 +1,23 @@
+#ifndef STRUCTURED_PART_VALIDATE_H
+#define STRUCTURED_PART_VALIDATE_H
+
+#include "blocks.h"
+#include <vector>
+
+namespace structured_part {
+
+// checks that blocks_on_procs is a valid decomposition of mesh_blocks and throws a
+// std::runtime_error describing the first problem found if it is not:
+//   * every SplitBlock is non-empty, lies inside its MeshBlock and its MeshBlock is in mesh_blocks
+//   * the SplitBlocks of each MeshBlock cover it exactly, with no gaps or overlaps
+//   * no proc has two SplitBlocks of the same MeshBlock (or, if allow_non_adjacent_siblings
+//     is true, two face-adjacent SplitBlocks of the same MeshBlock)
+// The cost is O(B log B) in the number of SplitBlocks B and does not depend on the number
+// of elements, so it can be used on every partition
+void validateDecomposition(const std::vector<std::shared_ptr<MeshBlock>>& mesh_blocks,
+                           const std::vector<std::vector<SplitBlock>>& blocks_on_procs,
+                           bool allow_non_adjacent_siblings=false);
+
+}
+
+#endif
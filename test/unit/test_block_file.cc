@@ -0,0 +1,39 @@
+#include "gtest/gtest.h"
+#include "block_file.h"
+#include "utils.h"
+
+#include <sstream>
+
+TEST(BlockFile, Read)
+{
+  std::istringstream is("# block_id nx ny nz weight\n"
+                        "0 10 20 1\n"
+                        "\n"
+                        "1 5 5 5 12.5  # comment\n");
+
+  auto mesh_blocks = readBlockFile(is);
+  ASSERT_EQ(mesh_blocks.size(), 2);
+  EXPECT_EQ(mesh_blocks[0]->block_id, 0);
+  EXPECT_EQ(mesh_blocks[0]->element_counts, make_array({10, 20, 1}));
+  EXPECT_EQ(mesh_blocks[0]->weight, 200);
+  EXPECT_EQ(mesh_blocks[1]->block_id, 1);
+  EXPECT_EQ(mesh_blocks[1]->element_counts, make_array({5, 5, 5}));
+  EXPECT_EQ(mesh_blocks[1]->weight, 12.5);
+}
+
+TEST(BlockFile, Invalid)
+{
+  std::istringstream missing_dimension("0 10 20\n");
+  EXPECT_ANY_THROW(readBlockFile(missing_dimension));
+
+  std::istringstream zero_dimension("0 10 0 1\n");
+  EXPECT_ANY_THROW(readBlockFile(zero_dimension));
+
+  std::istringstream negative_dimension("0 10 -20 1\n");
+  EXPECT_ANY_THROW(readBlockFile(negative_dimension));
+
+  std::istringstream extra_text("0 10 20 1 5 abc\n");
+  EXPECT_ANY_THROW(readBlockFile(extra_text));
+
+  EXPECT_ANY_THROW(readBlockFile("nonexistent_file.txt"));
+}
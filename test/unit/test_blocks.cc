@@ -1,5 +1,7 @@
 #include "gtest/gtest.h"
 #include "blocks.h"
+#include "cost_model.h"
+#include "memory_model.h"
 
 using namespace structured_part;
 
@@ -205,4 +207,73 @@ TEST(SplitBlock, RoundSmallerBlockDown)
   auto [left_block, right_block] = splitBlock(split_block, weight);
   EXPECT_EQ(left_block.element_counts[0], 393);
   EXPECT_EQ(right_block.element_counts[0], 7);  
-}
\ No newline at end of file
+}
+
+TEST(SplitBlock, SurfaceAreaAndCost)
+{
+  auto block = std::make_shared<MeshBlock>(1, 4, 5, 6);
+  EXPECT_EQ(computeSurfaceArea(SplitBlock(block)), 2*(30 + 24 + 20));
+
+  // the faces normal to k are not counted for 2D blocks
+  auto block_2d = std::make_shared<MeshBlock>(1, 4, 5, 1);
+  EXPECT_EQ(computeSurfaceArea(SplitBlock(block_2d)), 2*(5 + 4));
+
+  // a slab one element thick of a 3D block still has faces normal to k
+  auto block_tall = std::make_shared<MeshBlock>(1, 10, 10, 100);
+  EXPECT_EQ(computeSurfaceArea(SplitBlock(block_tall, {10, 10, 1}, {0, 0, 50})), 2*(10 + 10 + 100));
+  EXPECT_EQ(computeSurfaceArea(SplitBlock(block_tall, {10, 10, 2}, {0, 0, 50})), 2*(20 + 20 + 100));
+
+  CostModel cost_model;
+  EXPECT_EQ(computeBlockCost(SplitBlock(block_2d), cost_model), 20);
+
+  cost_model.per_block = 3;
+  cost_model.per_face_area = 0.5;
+  EXPECT_EQ(computeBlockCost(SplitBlock(block_2d), cost_model), 20 + 3 + 9);
+}
+
+TEST(SplitBlock, AllocatedCellsAndMemory)
+{
+  auto block = std::make_shared<MeshBlock>(1, 10, 10, 10);
+  EXPECT_EQ(computeAllocatedCells(SplitBlock(block), 2), 1000);
+  EXPECT_EQ(computeAllocatedCells(SplitBlock(block), 2, true), 14*14*14);
+
+  // ghost cells on the interior faces: the upper i face, both j faces and the lower k face
+  SplitBlock split_block(block, {4, 3, 5}, {0, 2, 5});
+  EXPECT_EQ(computeAllocatedCells(split_block, 2), (4 + 2)*(3 + 4)*(5 + 2));
+
+  // no ghost cells in the k direction for 2D blocks
+  auto block_2d = std::make_shared<MeshBlock>(1, 10, 10, 1);
+  EXPECT_EQ(computeAllocatedCells(SplitBlock(block_2d, {4, 10, 1}, {3, 0, 0}), 1, true), 6*12);
+
+  MemoryModel memory_model;
+  memory_model.ghost_width = 2;
+  memory_model.bytes_per_cell = 8;
+  memory_model.bytes_per_block = 100;
+  EXPECT_EQ(computeBlockMemory(split_block, memory_model), 8*6*7*7 + 100);
+  EXPECT_EQ(computeTotalMemory({split_block, SplitBlock(block)}, memory_model), 8*(6*7*7 + 1000) + 200);
+}
+
+TEST(SplitBlock, CandidateCuts)
+{
+  auto mesh_block = std::make_shared<MeshBlock>(0, 10, 40, 7);
+  std::vector<BlockCut> cuts = getCandidateCuts(SplitBlock(mesh_block), 0.25, 100);
+  ASSERT_EQ(cuts.size(), 6);
+  EXPECT_EQ(cuts[0].dir, 0); EXPECT_EQ(cuts[0].nelem, 2);  EXPECT_EQ(cuts[0].area, 280);
+  EXPECT_EQ(cuts[1].dir, 0); EXPECT_EQ(cuts[1].nelem, 3);
+  EXPECT_EQ(cuts[2].dir, 1); EXPECT_EQ(cuts[2].nelem, 10); EXPECT_EQ(cuts[2].area, 70);
+  EXPECT_EQ(cuts[3].dir, 1); EXPECT_EQ(cuts[3].nelem, 11);
+  EXPECT_EQ(cuts[4].dir, 2); EXPECT_EQ(cuts[4].nelem, 1);  EXPECT_EQ(cuts[4].area, 400);
+  EXPECT_EQ(cuts[5].dir, 2); EXPECT_EQ(cuts[5].nelem, 2);
+
+  // only the cut along the j direction keeps the aspect ratio below 7
+  cuts = getCandidateCuts(SplitBlock(mesh_block), 0.25, 7);
+  ASSERT_EQ(cuts.size(), 2);
+  EXPECT_EQ(cuts[0].dir, 1);
+  EXPECT_EQ(cuts[1].dir, 1);
+
+  // 2D blocks are never cut in the k direction, and the cuts are clamped to leave an element on each side
+  cuts = getCandidateCuts(SplitBlock(std::make_shared<MeshBlock>(0, 2, 4, 1)), 0.9, 100);
+  ASSERT_EQ(cuts.size(), 2);
+  EXPECT_EQ(cuts[0].dir, 0); EXPECT_EQ(cuts[0].nelem, 1);
+  EXPECT_EQ(cuts[1].dir, 1); EXPECT_EQ(cuts[1].nelem, 3);
+}
@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+#include "calibrate.h"
+#include "structured_part.h"
+#include "utils.h"
+
+namespace {
+
+// time per element of each MeshBlock, and time per SplitBlock
+const std::vector<double> true_element_costs = {1, 3, 1, 2};
+constexpr double true_overhead = 500;
+
+std::vector<std::shared_ptr<MeshBlock>> createMeshBlocks()
+{
+  return {std::make_shared<MeshBlock>(0, 40, 30, 20),
+          std::make_shared<MeshBlock>(1, 25, 25, 25),
+          std::make_shared<MeshBlock>(2, 60, 40, 1),
+          std::make_shared<MeshBlock>(3, 30, 30, 10)};
+}
+
+std::vector<double> computeTrueTimes(const std::vector<std::vector<SplitBlock>>& blocks_on_procs)
+{
+  std::vector<double> times;
+  for (auto& blocks : blocks_on_procs)
+  {
+    double time = 0;
+    for (auto& block : blocks)
+      time += true_element_costs[block.meshblock->block_id] * prod(block.element_counts) + true_overhead;
+    times.push_back(time);
+  }
+
+  return times;
+}
+
+double computeImbalance(const std::vector<double>& times)
+{
+  double max_time = 0, avg_time = 0;
+  for (double time : times)
+  {
+    max_time = std::max(max_time, time);
+    avg_time += time / times.size();
+  }
+
+  return max_time / avg_time - 1;
+}
+
+}
+
+TEST(Calibrate, RecoversElementCosts)
+{
+  auto mesh_blocks = createMeshBlocks();
+  auto blocks_on_procs = partitionMesh(mesh_blocks, 16, 0.05);
+
+  CalibrationOptions options;
+  options.fit_block_overhead = true;
+  options.regularization = 1e-10;
+  WeightCalibration calibration = calibrateWeights(mesh_blocks, blocks_on_procs, computeTrueTimes(blocks_on_procs), options);
+
+  double total_weight = 0, new_total_weight = 0;
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+  {
+    total_weight += mesh_blocks[i]->weight;
+    new_total_weight += calibration.weights[i];
+  }
+  EXPECT_NEAR(new_total_weight, total_weight, 1e-8 * total_weight);
+
+  double weight_per_time = calibration.weights[0] / (true_element_costs[0] * prod(mesh_blocks[0]->element_counts));
+  for (UInt i=0; i < mesh_blocks.size(); ++i)
+    EXPECT_NEAR(calibration.weights[i], weight_per_time * true_element_costs[i] * prod(mesh_blocks[i]->element_counts),
+                1e-4 * calibration.weights[i]);
+
+  EXPECT_NEAR(calibration.cost_model.per_block, weight_per_time * true_overhead, 1e-3 * weight_per_time * true_overhead);
+  EXPECT_NEAR(calibration.rms_relative_residual, 0, 1e-6);
+}
+
+TEST(Calibrate, ImbalanceConverges)
+{
+  auto mesh_blocks = createMeshBlocks();
+  PartitionOptions options;
+  options.max_iterations = 1000;
+
+  PartitionResult result = partitionMesh(mesh_blocks, 16, 0.02, options);
+  double initial_imbalance = computeImbalance(computeTrueTimes(result.blocks_on_procs));
+
+  CalibrationOptions calibration_options;
+  calibration_options.fit_block_overhead = true;
+  for (int i=0; i < 3; ++i)
+  {
+    WeightCalibration calibration = calibrateWeights(mesh_blocks, result.blocks_on_procs, computeTrueTimes(result.blocks_on_procs),
+                                                     calibration_options);
+    applyCalibration(mesh_blocks, calibration);
+    options.cost_model = calibration.cost_model;
+    result = partitionMesh(mesh_blocks, 16, 0.02, options);
+  }
+
+  double final_imbalance = computeImbalance(computeTrueTimes(result.blocks_on_procs));
+  EXPECT_GT(initial_imbalance, 0.2);
+  EXPECT_LT(final_imbalance, 0.1);
+}
+
+TEST(Calibrate, Errors)
+{
+  auto mesh_blocks = createMeshBlocks();
+  auto blocks_on_procs = partitionMesh(mesh_blocks, 4, 0.1);
+  EXPECT_ANY_THROW(calibrateWeights(mesh_blocks, blocks_on_procs, {1, 2, 3}));
+  EXPECT_ANY_THROW(calibrateWeights({mesh_blocks[0]}, blocks_on_procs, {1, 2, 3, 4}));
+}
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include "compact_decomp.h"
+#include "final_split.h"
+#include "pre_split.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+bool isBefore(const SplitBlock& lhs, const SplitBlock& rhs)
+{
+  if (lhs.meshblock->block_id != rhs.meshblock->block_id)
+    return lhs.meshblock->block_id < rhs.meshblock->block_id;
+
+  return lhs.mesh_offsets < rhs.mesh_offsets;
+}
+
+void checkSameDecomposition(std::vector<std::vector<SplitBlock>> lhs, std::vector<std::vector<SplitBlock>> rhs)
+{
+  ASSERT_EQ(lhs.size(), rhs.size());
+  for (UInt proc=0; proc < lhs.size(); ++proc)
+  {
+    std::sort(lhs[proc].begin(), lhs[proc].end(), isBefore);
+    std::sort(rhs[proc].begin(), rhs[proc].end(), isBefore);
+    EXPECT_EQ(lhs[proc], rhs[proc]);
+  }
+}
+
+}
+
+TEST(CompactDecomposition, RegularGrid)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 400, 400, 1)};
+  std::vector<SplitBlock> split_blocks = recursivelySplitBlock(mesh_blocks[0], 64);
+  std::vector<std::vector<SplitBlock>> blocks_on_procs;
+  for (const SplitBlock& split_block : split_blocks)
+    blocks_on_procs.push_back({split_block});
+
+  CompactDecomposition compact(mesh_blocks, blocks_on_procs);
+  EXPECT_EQ(compact.getNumBlocks(), 64);
+  EXPECT_EQ(compact.getNumCells(0), 64);
+  EXPECT_EQ(compact.getNumExceptions(0), 0);
+  EXPECT_EQ(compact.getCuts(0, 0).size(), 9);
+  EXPECT_EQ(compact.getCuts(0, 1).size(), 9);
+  EXPECT_EQ(compact.getCuts(0, 2).size(), 2);
+
+  for (UInt slot=0; slot < compact.getNumSlots(0); ++slot)
+  {
+    EXPECT_EQ(compact.getBlock(0, slot), split_blocks[slot]);
+    EXPECT_EQ(compact.getRank(0, slot), slot);
+  }
+
+  EXPECT_EQ(compact.getOwner(0, {0, 0, 0}), 0);
+  EXPECT_EQ(compact.getOwner(0, {399, 399, 0}), 63);
+  EXPECT_LT(10*compact.getMemoryUsage(), computeMemoryUsage(blocks_on_procs));
+}
+
+TEST(CompactDecomposition, RoundTrip)
+{
+  double load_balance_factor = 0.1;
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 101, 100, 1),
+                                                         std::make_shared<MeshBlock>(1, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(2, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(3, 10, 10, 1)};
+
+  for (UInt nprocs=1; nprocs < 40; ++nprocs)
+  {
+    auto blocks_on_procs = finalSplit(mesh_blocks, nprocs, load_balance_factor);
+    CompactDecomposition compact(mesh_blocks, blocks_on_procs);
+    checkSameDecomposition(compact.expand(), blocks_on_procs);
+
+    for (UInt proc=0; proc < nprocs; ++proc)
+      for (const SplitBlock& block : blocks_on_procs[proc])
+        EXPECT_EQ(compact.getOwner(block.meshblock->block_id, block.mesh_offsets), proc);
+  }
+}
+
+TEST(CompactDecomposition, UnknownMeshBlock)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 10, 10, 1)};
+  auto other_block = std::make_shared<MeshBlock>(1, 10, 10, 1);
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = {{SplitBlock(mesh_blocks[0])}, {SplitBlock(other_block)}};
+
+  EXPECT_ANY_THROW(CompactDecomposition(mesh_blocks, blocks_on_procs));
+}
+
+TEST(CompactDecomposition, WriteRead)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 101, 100, 1),
+                                                         std::make_shared<MeshBlock>(1, 100, 100, 1, 3.5)};
+  auto blocks_on_procs = finalSplit(mesh_blocks, 11, 0.1);
+  CompactDecomposition compact(mesh_blocks, blocks_on_procs);
+
+  std::stringstream ss;
+  compact.write(ss);
+  CompactDecomposition compact2 = CompactDecomposition::read(ss);
+
+  ASSERT_EQ(compact2.getNumMeshBlocks(), compact.getNumMeshBlocks());
+  EXPECT_EQ(compact2.getNumProcs(), compact.getNumProcs());
+  EXPECT_EQ(compact2.getNumBlocks(), compact.getNumBlocks());
+  for (UInt i=0; i < compact.getNumMeshBlocks(); ++i)
+  {
+    EXPECT_EQ(compact2.getMeshBlock(i)->block_id, mesh_blocks[i]->block_id);
+    EXPECT_EQ(compact2.getMeshBlock(i)->element_counts, mesh_blocks[i]->element_counts);
+    EXPECT_EQ(compact2.getMeshBlock(i)->weight, mesh_blocks[i]->weight);
+    ASSERT_EQ(compact2.getNumSlots(i), compact.getNumSlots(i));
+    for (UInt slot=0; slot < compact.getNumSlots(i); ++slot)
+    {
+      EXPECT_EQ(compact2.getRank(i, slot), compact.getRank(i, slot));
+      EXPECT_EQ(compact2.getBlock(i, slot).element_counts, compact.getBlock(i, slot).element_counts);
+      EXPECT_EQ(compact2.getBlock(i, slot).mesh_offsets, compact.getBlock(i, slot).mesh_offsets);
+    }
+  }
+}
+
+TEST(CompactDecomposition, ReadInvalid)
+{
+  std::istringstream is("structured_part_decomposition 2 1\nmeshblock 0 10 10 1 100\ncuts 2 0 10\n");
+  EXPECT_ANY_THROW(CompactDecomposition::read(is));
+
+  std::string valid_meshblock = "meshblock 0 10 10 1 100\ncuts 2 0 10\ncuts 3 0 5 10\ncuts 2 0 1\n";
+  std::istringstream valid("structured_part_decomposition 2 1\n" + valid_meshblock + "ranks 2 0 1\nexceptions 0\n");
+  EXPECT_EQ(CompactDecomposition::read(valid).getNumBlocks(), 2);
+
+  // a rank >= nprocs
+  std::istringstream bad_rank("structured_part_decomposition 2 1\n" + valid_meshblock + "ranks 2 0 2\nexceptions 0\n");
+  EXPECT_ANY_THROW(CompactDecomposition::read(bad_rank));
+
+  std::istringstream bad_exception_rank("structured_part_decomposition 2 1\n" + valid_meshblock + "ranks 2 0 1\nexceptions 1\n1 1 1 0 0 0 5\n");
+  EXPECT_ANY_THROW(CompactDecomposition::read(bad_exception_rank));
+
+  std::istringstream exception_outside("structured_part_decomposition 2 1\n" + valid_meshblock + "ranks 2 0 1\nexceptions 1\n1 1 1 10 0 0 1\n");
+  EXPECT_ANY_THROW(CompactDecomposition::read(exception_outside));
+
+  // counts that would allocate a lot of memory, and negative values
+  std::istringstream huge_cuts("structured_part_decomposition 2 1\nmeshblock 0 10 10 1 100\ncuts 1000000000000 0 10\n");
+  EXPECT_ANY_THROW(CompactDecomposition::read(huge_cuts));
+
+  std::istringstream huge_exceptions("structured_part_decomposition 2 1\n" + valid_meshblock + "ranks 2 0 1\nexceptions 1000000000000\n");
+  EXPECT_ANY_THROW(CompactDecomposition::read(huge_exceptions));
+
+  std::istringstream huge_meshblocks("structured_part_decomposition 2 1000000000000\n" + valid_meshblock + "ranks 2 0 1\nexceptions 0\n");
+  EXPECT_ANY_THROW(CompactDecomposition::read(huge_meshblocks));
+
+  std::istringstream negative_nprocs("structured_part_decomposition -2 1\n" + valid_meshblock + "ranks 2 0 1\nexceptions 0\n");
+  EXPECT_ANY_THROW(CompactDecomposition::read(negative_nprocs));
+
+  std::istringstream unsorted_cuts("structured_part_decomposition 2 1\nmeshblock 0 10 10 1 100\ncuts 3 0 10 10\n");
+  EXPECT_ANY_THROW(CompactDecomposition::read(unsorted_cuts));
+}
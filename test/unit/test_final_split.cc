@@ -3,6 +3,9 @@
 #include "statistics.h"
 #include "utils.h"
 
+#include <numeric>
+#include <sstream>
+
 TEST(FinalSplit, StatsSingleBlock)
 {
   UInt nprocs = 7;
@@ -35,4 +38,83 @@ TEST(FinalSplit, Stats4Blocks)
   std::cout << stats << std::endl;
   printPerProcessStats(std::cout, stats);
   printHistogram(std::cout, stats);
-}
\ No newline at end of file
+}
+
+TEST(FinalSplit, BestCut)
+{
+  // over these meshes, picking the cut by the reassignment it leads to takes no more iterations
+  // and cuts no more surface in total than always cutting the longest axis.  Single meshes can
+  // go either way
+  std::vector<std::vector<std::shared_ptr<MeshBlock>>> meshes =
+    {{std::make_shared<MeshBlock>(0, 100, 100, 1), std::make_shared<MeshBlock>(1, 37, 80, 1),
+      std::make_shared<MeshBlock>(2, 20, 100, 1)},
+     {std::make_shared<MeshBlock>(0, 60, 40, 30), std::make_shared<MeshBlock>(1, 25, 35, 45)}};
+  UInt num_iterations = 0, longest_axis_num_iterations = 0, cut_surface = 0, longest_axis_cut_surface = 0;
+  for (auto& mesh_blocks : meshes)
+    for (UInt nprocs : {5, 7, 13, 17, 23, 40})
+    {
+      PartitionOptions options;
+      PartitionResult longest_axis_result = finalSplit(mesh_blocks, nprocs, 0.05, options);
+      options.cut_selection = CutSelection::BestCut;
+      PartitionResult result = finalSplit(mesh_blocks, nprocs, 0.05, options);
+      checkDecompositionValid(mesh_blocks, result.blocks_on_procs);
+      EXPECT_EQ(result.status, PartitionStatus::Balanced);
+      checkLoadBalance(result.blocks_on_procs, 0.05);
+
+      num_iterations += result.num_iterations;
+      longest_axis_num_iterations += longest_axis_result.num_iterations;
+      cut_surface += computeDecompStats(result.blocks_on_procs).cut_surface;
+      longest_axis_cut_surface += computeDecompStats(longest_axis_result.blocks_on_procs).cut_surface;
+    }
+
+  EXPECT_LE(num_iterations, longest_axis_num_iterations);
+  EXPECT_LE(cut_surface, longest_axis_cut_surface);
+}
+
+TEST(FinalSplit, MemoryLimit)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 60, 60, 60),
+                                                         std::make_shared<MeshBlock>(1, 30, 40, 50)};
+  UInt nprocs = 10;
+  PartitionOptions options;
+  options.memory_model.ghost_width = 2;
+  options.memory_model.bytes_per_cell = 8;
+  options.memory_model.bytes_per_block = 1000;
+
+  // with a loose load balance factor, the memory of the procs is uneven
+  PartitionResult result = finalSplit(mesh_blocks, nprocs, 0.5, options);
+  MemoryStats stats = computeMemoryStats(result.blocks_on_procs, options.memory_model);
+  EXPECT_EQ(std::accumulate(stats.histogram.begin(), stats.histogram.end(), UInt(0)), nprocs);
+  EXPECT_EQ(stats.memory_per_process[stats.max_memory_proc], stats.max_memory);
+  EXPECT_GT(stats.max_memory, 1.15 * stats.avg_memory_per_process);
+
+  options.max_memory_per_rank = 1.15 * stats.avg_memory_per_process;
+  result = finalSplit(mesh_blocks, nprocs, 0.5, options);
+  checkDecompositionValid(mesh_blocks, result.blocks_on_procs);
+  EXPECT_EQ(result.status, PartitionStatus::Balanced);
+  checkLoadBalance(result.blocks_on_procs, 0.5);
+  EXPECT_LE(computeMemoryStats(result.blocks_on_procs, options.memory_model).max_memory, options.max_memory_per_rank);
+
+  // the limit cannot be achieved, but the decomposition with the least memory is returned
+  options.max_memory_per_rank = 0.5 * stats.avg_memory_per_process;
+  result = finalSplit(mesh_blocks, nprocs, 0.5, options);
+  checkDecompositionValid(mesh_blocks, result.blocks_on_procs);
+  EXPECT_NE(result.status, PartitionStatus::Balanced);
+  EXPECT_LT(computeMemoryStats(result.blocks_on_procs, options.memory_model).max_memory, stats.max_memory);
+}
+
+TEST(FinalSplit, MemoryStatsNoProcs)
+{
+  MemoryModel memory_model;
+  MemoryStats stats = computeMemoryStats({}, memory_model);
+  EXPECT_EQ(stats.min_memory, 0.0);
+  EXPECT_EQ(stats.max_memory, 0.0);
+  EXPECT_EQ(stats.avg_memory_per_process, 0.0);
+
+  std::stringstream ss;
+  ss << stats;
+  printHistogram(ss, stats);
+  ss << MemoryStats();
+  printHistogram(ss, MemoryStats());
+  EXPECT_EQ(ss.str(), "no processesno processes");
+}
@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+#include "plot3d.h"
+#include "utils.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+class Plot3DWriter
+{
+  public:
+    Plot3DWriter(const std::string& fname, bool record_markers, bool swap_bytes) :
+      m_file(fname, std::ios::binary),
+      m_record_markers(record_markers),
+      m_swap_bytes(swap_bytes)
+    {}
+
+    void write(const std::vector<std::array<int32_t, 3>>& dims, bool multi_block, UInt dim=3)
+    {
+      if (multi_block)
+        writeRecord({int32_t(dims.size())});
+
+      std::vector<int32_t> dims_record;
+      for (auto& block_dims : dims)
+        for (UInt d=0; d < dim; ++d)
+          dims_record.push_back(block_dims[d]);
+      writeRecord(dims_record);
+
+      for (auto& block_dims : dims)
+      {
+        std::vector<int32_t> coords(3*block_dims[0]*block_dims[1]*block_dims[2], 0);
+        writeRecord(coords);
+      }
+    }
+
+  private:
+    void writeRecord(const std::vector<int32_t>& vals)
+    {
+      if (m_record_markers)
+        writeInt(vals.size()*sizeof(int32_t));
+
+      for (int32_t val : vals)
+        writeInt(val);
+
+      if (m_record_markers)
+        writeInt(vals.size()*sizeof(int32_t));
+    }
+
+    void writeInt(int32_t val)
+    {
+      uint32_t uval = val;
+      if (m_swap_bytes)
+        uval = ((uval & 0xff) << 24) | ((uval & 0xff00) << 8) | ((uval & 0xff0000) >> 8) | (uval >> 24);
+      m_file.write(reinterpret_cast<const char*>(&uval), sizeof(uval));
+    }
+
+    std::ofstream m_file;
+    bool m_record_markers;
+    bool m_swap_bytes;
+};
+
+std::string getFileName()
+{
+  return std::string("test_plot3d_") + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".xyz";
+}
+
+}
+
+TEST(Plot3D, MultiBlockAllFormats)
+{
+  std::vector<std::array<int32_t, 3>> dims = {{5, 6, 7}, {3, 4, 2}, {11, 2, 2}};
+  for (bool record_markers : {false, true})
+    for (bool swap_bytes : {false, true})
+    {
+      std::string fname = getFileName();
+      Plot3DWriter(fname, record_markers, swap_bytes).write(dims, true);
+
+      auto mesh_blocks = readPlot3DBlocks(fname);
+      std::remove(fname.c_str());
+
+      ASSERT_EQ(mesh_blocks.size(), dims.size());
+      for (UInt i=0; i < dims.size(); ++i)
+      {
+        EXPECT_EQ(mesh_blocks[i]->block_id, Int(i));
+        EXPECT_EQ(mesh_blocks[i]->element_counts, make_array({UInt(dims[i][0] - 1), UInt(dims[i][1] - 1), UInt(dims[i][2] - 1)}));
+      }
+    }
+}
+
+TEST(Plot3D, SingleBlockRecordMarkers)
+{
+  std::string fname = getFileName();
+  Plot3DWriter(fname, true, false).write({{5, 6, 7}}, false);
+
+  auto mesh_blocks = readPlot3DBlocks(fname);
+  std::remove(fname.c_str());
+
+  ASSERT_EQ(mesh_blocks.size(), 1);
+  EXPECT_EQ(mesh_blocks[0]->element_counts, make_array({4, 5, 6}));
+}
+
+TEST(Plot3D, SingleBlockNoRecordMarkers)
+{
+  for (bool swap_bytes : {false, true})
+  {
+    std::string fname = getFileName();
+    Plot3DWriter(fname, false, swap_bytes).write({{5, 6, 7}}, false);
+
+    auto mesh_blocks = readPlot3DBlocks(fname);
+    std::remove(fname.c_str());
+
+    ASSERT_EQ(mesh_blocks.size(), 1);
+    EXPECT_EQ(mesh_blocks[0]->element_counts, make_array({4, 5, 6}));
+  }
+}
+
+TEST(Plot3D, MultiBlock2D)
+{
+  std::string fname = getFileName();
+  Plot3DWriter(fname, true, true).write({{5, 6, 1}, {3, 9, 1}}, true, 2);
+
+  auto mesh_blocks = readPlot3DBlocks(fname);
+  std::remove(fname.c_str());
+
+  ASSERT_EQ(mesh_blocks.size(), 2);
+  EXPECT_EQ(mesh_blocks[0]->element_counts, make_array({4, 5, 1}));
+  EXPECT_EQ(mesh_blocks[1]->element_counts, make_array({2, 8, 1}));
+}
+
+TEST(Plot3D, Invalid)
+{
+  std::string fname = getFileName();
+  {
+    std::ofstream file(fname, std::ios::binary);
+    file << "this is not a plot3d file";
+  }
+
+  EXPECT_ANY_THROW(readPlot3DBlocks(fname));
+  std::remove(fname.c_str());
+
+  EXPECT_ANY_THROW(readPlot3DBlocks("nonexistent_file.xyz"));
+}
@@ -1,7 +1,9 @@
 #include "gtest/gtest.h"
 #include "pre_split.h"
+#include "assign_blocks_to_procs.h"
 #include "statistics.h"
 #include "final_split.h"
+#include "validate.h"
 #include "utils.h"
 
 using namespace structured_part;
@@ -91,6 +93,50 @@ TEST(Presplit, SplitSingleBlockThreeProcs2x2x1)
   EXPECT_EQ(split_blocks[2].weight, mesh_block->weight/2); 
 }
 
+TEST(Presplit, SplitThinBlockGridChanges)
+{
+  // the main block of 33 x 54 cannot be split into a grid of 3 blocks
+  auto mesh_block = std::make_shared<MeshBlock>(0, 33, 71, 1);
+
+  std::vector<SplitBlock> split_blocks = recursivelySplitBlock(mesh_block, 4);
+  EXPECT_EQ(split_blocks.size(), 4U);
+  checkDecompositionValid({mesh_block}, {split_blocks});
+}
+
+TEST(Presplit, Split2DMatches3D)
+{
+  auto mesh_block = std::make_shared<MeshBlock>(0, 37, 20, 1);
+  SplitBlock block(mesh_block, {30, 17, 1}, {5, 2, 0});
+
+  for (UInt num_split_blocks=1; num_split_blocks < 40; ++num_split_blocks)
+  {
+    std::array<UInt, 3> grid = computeEvenlyDivisibleBlockGrid<2>(block, num_split_blocks);
+    EXPECT_EQ(grid, computeEvenlyDivisibleBlockGrid<3>(block, num_split_blocks));
+
+    auto num_elem_per_block = computeNumElementsPerBlock<2>(block, grid);
+    EXPECT_EQ(num_elem_per_block, computeNumElementsPerBlock<3>(block, grid));
+    EXPECT_EQ(createSplitBlocks<2>(block, num_elem_per_block), createSplitBlocks<3>(block, num_elem_per_block));
+  }
+}
+
+TEST(Presplit, SplitIntoBuffer)
+{
+  auto mesh_block1 = std::make_shared<MeshBlock>(0, 33, 71, 5);
+  auto mesh_block2 = std::make_shared<MeshBlock>(0, 20, 20, 1);
+
+  std::vector<SplitBlock> split_blocks;
+  recursivelySplitBlock(SplitBlock(mesh_block1), 11, split_blocks);
+  recursivelySplitBlock(SplitBlock(mesh_block2), 7, split_blocks);
+
+  std::vector<SplitBlock> split_blocks1 = recursivelySplitBlock(mesh_block1, 11);
+  std::vector<SplitBlock> split_blocks2 = recursivelySplitBlock(mesh_block2, 7);
+  ASSERT_EQ(split_blocks.size(), 18U);
+  EXPECT_TRUE(std::equal(split_blocks1.begin(), split_blocks1.end(), split_blocks.begin()));
+  EXPECT_TRUE(std::equal(split_blocks2.begin(), split_blocks2.end(), split_blocks.begin() + 11));
+  checkDecompositionValid({mesh_block1}, {split_blocks1});
+  checkDecompositionValid({mesh_block2}, {split_blocks2});
+}
+
 
 //-----------------------------------------------------------------------------
 // Test computeNumSubBlocks
@@ -146,6 +192,27 @@ TEST(Presplit, NumSubBlocks2Blocks3ProcsUneven)
   EXPECT_EQ(num_sub_blocks[1], 1);
 }
 
+TEST(Presplit, NumSubBlocksInteger)
+{
+  EXPECT_EQ(computeNumSubBlocks(std::vector<IntWeight>{200, 100}, 2), std::vector<UInt>({2, 1}));
+  EXPECT_EQ(computeNumSubBlocks(std::vector<IntWeight>{300, 100}, 4), std::vector<UInt>({3, 1}));
+  EXPECT_EQ(computeNumSubBlocks(std::vector<IntWeight>{1, 1, 1}, 2), std::vector<UInt>({1, 1, 1}));
+  EXPECT_EQ(computeNumSubBlocks(std::vector<IntWeight>{1, 0}, 3), std::vector<UInt>({3, 1}));
+}
+
+TEST(Presplit, NumSubBlocksMinMax)
+{
+  EXPECT_EQ(computeNumSubBlocksMinMax(std::vector<double>{5, 3, 2}, 10, 10), std::vector<UInt>({5, 3, 2}));
+  EXPECT_EQ(computeNumSubBlocksMinMax(std::vector<double>{5, 3, 2}, 10, 3), std::vector<UInt>({1, 1, 1}));
+  EXPECT_EQ(computeNumSubBlocksMinMax(std::vector<double>{3, 1}, 4, 4), std::vector<UInt>({3, 1}));
+
+  // no block can be split into more than nprocs sub-blocks
+  EXPECT_EQ(computeNumSubBlocksMinMax(std::vector<double>{3, 1}, 2, 4), std::vector<UInt>({2, 2}));
+
+  EXPECT_ANY_THROW(computeNumSubBlocksMinMax(std::vector<double>{3, 1}, 2, 1));
+  EXPECT_ANY_THROW(computeNumSubBlocksMinMax(std::vector<double>{3, 1}, 2, 5));
+}
+
 
 // ----------------------------------------------------------------------------
 // Test assignBlocksToProcs
@@ -225,6 +292,25 @@ TEST(Presplit, AssignBlocksToProcs3Block2ProcThrow)
 }
 
 
+TEST(Presplit, AssignBlocksToProcsInteger)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 10, 10, 1),
+                                                         std::make_shared<MeshBlock>(1, 10, 10, 1)};
+
+  std::vector<SplitBlock> split_blocks = {SplitBlock(mesh_blocks[0], {5, 10, 1}, {0, 0, 0}),
+                                          SplitBlock(mesh_blocks[0], {5, 10, 1}, {5, 0, 0}),
+                                          SplitBlock(mesh_blocks[1], {10, 10, 1}, {0, 0, 0})};
+  std::vector<IntWeight> weights = {50, 50, 100};
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = assignBlocksToProcs(split_blocks, weights, 2);
+
+  // the largest block goes first, then the equal blocks in order
+  ASSERT_EQ(blocks_on_procs.size(), 2);
+  EXPECT_EQ(blocks_on_procs[0], std::vector<SplitBlock>({split_blocks[2], split_blocks[1]}));
+  EXPECT_EQ(blocks_on_procs[1], std::vector<SplitBlock>({split_blocks[0]}));
+
+  EXPECT_ANY_THROW(assignBlocksToProcs(split_blocks, weights, 1));
+}
+
 //-----------------------------------------------------------------------------
 // Test: end-to-end decomposition
 
@@ -255,4 +341,56 @@ TEST(Presplit, Stats4Blocks)
   std::cout << stats << std::endl;
   printPerProcessStats(std::cout, stats);
   printHistogram(std::cout, stats);
-}
\ No newline at end of file
+}
+
+TEST(Presplit, StatsCutSurface)
+{
+  auto mesh_block = std::make_shared<MeshBlock>(0, 10, 20, 30);
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = {{SplitBlock(mesh_block, {10, 20, 10}, {0, 0, 0})},
+                                                          {SplitBlock(mesh_block, {10, 20, 20}, {0, 0, 10})}};
+
+  DecompStats stats = computeDecompStats(blocks_on_procs);
+  EXPECT_EQ(stats.cut_surface, 200);
+
+  // the two faces next to the uncovered parts of the MeshBlock count as half a face each
+  EXPECT_EQ(computeCutSurface({{SplitBlock(mesh_block, {10, 20, 10}, {0, 0, 10})}}), 200);
+  EXPECT_DOUBLE_EQ(stats.max_aspect_ratio, 2);
+  EXPECT_DOUBLE_EQ(computeAspectRatio(SplitBlock(std::make_shared<MeshBlock>(0, 10, 40, 1))), 4);
+}
+
+TEST(Presplit, SpreadRemainderOverRows)
+{
+  for (auto mesh_block : {std::make_shared<MeshBlock>(0, 100, 100, 100), std::make_shared<MeshBlock>(0, 64, 64, 1)})
+    for (UInt num_blocks : {12, 13, 101})
+    {
+      std::vector<std::vector<SplitBlock>> blocks_nested, blocks_spread;
+      for (auto& block : recursivelySplitBlock(SplitBlock(mesh_block), num_blocks))
+        blocks_nested.push_back({block});
+
+      std::vector<SplitBlock> split_blocks;
+      recursivelySplitBlock(SplitBlock(mesh_block), num_blocks, split_blocks, RemainderStrategy::SpreadOverRows);
+      for (auto& block : split_blocks)
+        blocks_spread.push_back({block});
+
+      ASSERT_EQ(blocks_spread.size(), num_blocks);
+      validateDecomposition({mesh_block}, blocks_spread);
+
+      DecompStats stats_nested = computeDecompStats(blocks_nested);
+      DecompStats stats_spread = computeDecompStats(blocks_spread);
+      EXPECT_LE(stats_spread.max_aspect_ratio, 2);
+      if (num_blocks == 12)
+        EXPECT_EQ(stats_spread.cut_surface, stats_nested.cut_surface);  // exact grid
+      else
+        EXPECT_LT(stats_spread.cut_surface, stats_nested.cut_surface);
+    }
+}
+
+TEST(Presplit, RemainderStrategyOption)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(1, 64, 80, 1)};
+  PartitionOptions options;
+  options.remainder_strategy = RemainderStrategy::SpreadOverRows;
+  auto blocks_on_procs = preSplit(mesh_blocks, 13, options);
+  checkDecompositionValid(mesh_blocks, blocks_on_procs);
+}
@@ -0,0 +1,50 @@
+#include "gtest/gtest.h"
+#include "rank_advisor.h"
+#include "utils.h"
+
+TEST(RankAdvisor, CandidateRankCounts)
+{
+  EXPECT_EQ(getCandidateRankCounts(1), std::vector<UInt>({1}));
+  EXPECT_EQ(getCandidateRankCounts(10), std::vector<UInt>({1, 2, 3, 4, 5, 6, 8, 9, 10}));
+}
+
+TEST(RankAdvisor, NoOverheadUsesAllRanks)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(1, 50, 100, 1)};
+
+  std::vector<RankCountEstimate> estimates = evaluateRankCounts(mesh_blocks, getCandidateRankCounts(40), 0.05, CostModel());
+  EXPECT_EQ(recommendRankCount(estimates).nprocs, 40);
+  for (const RankCountEstimate& estimate : estimates)
+    EXPECT_GE(estimate.efficiency, 1/1.05 - 1e-12);
+}
+
+TEST(RankAdvisor, Recommend)
+{
+  std::vector<RankCountEstimate> estimates = {{1, 100, 1, 1}, {2, 60, 100.0/60, 100.0/120}, {4, 50, 2, 0.5}, {8, 45, 100.0/45, 100.0/360}};
+  EXPECT_EQ(recommendRankCount(estimates).nprocs, 8);
+  EXPECT_EQ(recommendRankCount(estimates, 0.15).nprocs, 4);
+  EXPECT_EQ(recommendRankCount(estimates, 1.0).nprocs, 2);
+}
+
+TEST(RankAdvisor, HaloCostLeavesRanksIdle)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 20, 20, 1),
+                                                         std::make_shared<MeshBlock>(1, 10, 20, 1)};
+  CostModel cost_model;
+  cost_model.per_block = 50;
+  cost_model.per_face_area = 2;
+
+  UInt nprocs = 64;
+  double tolerance = 0.25;
+  std::vector<RankCountEstimate> estimates = evaluateRankCounts(mesh_blocks, getCandidateRankCounts(nprocs), 0.1, cost_model);
+  RankCountEstimate best = recommendRankCount(estimates, tolerance);
+  EXPECT_LT(best.nprocs, nprocs);
+  EXPECT_GT(best.efficiency, estimates.back().efficiency);
+
+  auto blocks_on_procs = partitionMeshWithIdleRanks(mesh_blocks, nprocs, 0.1, cost_model, tolerance);
+  ASSERT_EQ(blocks_on_procs.size(), nprocs);
+  checkDecompositionValid(mesh_blocks, blocks_on_procs);
+  for (UInt proc=best.nprocs; proc < nprocs; ++proc)
+    EXPECT_EQ(blocks_on_procs[proc].size(), 0);
+}
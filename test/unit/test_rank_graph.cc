@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include "rank_graph.h"
+#include "statistics.h"
+#include "structured_part.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <sstream>
+
+TEST(RankGraph, TwoBlocks)
+{
+  auto mesh_block0 = std::make_shared<MeshBlock>(0, 4, 6, 1);
+  auto mesh_block1 = std::make_shared<MeshBlock>(1, 3, 3, 1);
+
+  // mesh_block0 is split into 3 strips in j, rank 2 has the middle strip and mesh_block1, which
+  // is not connected to mesh_block0
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = {{SplitBlock(mesh_block0, {4, 2, 1}, {0, 0, 0})},
+                                                          {SplitBlock(mesh_block0, {4, 2, 1}, {0, 4, 0})},
+                                                          {SplitBlock(mesh_block0, {4, 2, 1}, {0, 2, 0}), SplitBlock(mesh_block1)},
+                                                          {}};
+  RankGraph graph = computeRankGraph(blocks_on_procs);
+  EXPECT_EQ(graph.vertex_weights, std::vector<double>({8, 8, 17, 0}));
+  EXPECT_EQ(graph.getNumEdges(), 2);
+  EXPECT_EQ(graph.neighbors[0], (std::vector<std::pair<UInt, UInt>>{{2, 4}}));
+  EXPECT_EQ(graph.neighbors[1], (std::vector<std::pair<UInt, UInt>>{{2, 4}}));
+  EXPECT_EQ(graph.neighbors[2], (std::vector<std::pair<UInt, UInt>>{{0, 4}, {1, 4}}));
+  EXPECT_EQ(graph.neighbors[3].size(), 0);
+
+  std::stringstream ss;
+  writeMetisGraph(ss, graph);
+  EXPECT_EQ(ss.str(), "4 2 011\n8 3 4\n8 3 4\n17 1 4 2 4\n0\n");
+}
+
+TEST(RankGraph, HaloAreaMatchesCommStats)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 40, 30, 20),
+                                                         std::make_shared<MeshBlock>(1, 25, 25, 25)};
+  auto blocks_on_procs = partitionMesh(mesh_blocks, 23, 0.05);
+  RankGraph graph = computeRankGraph(blocks_on_procs);
+
+  // every rank pair is listed from both sides
+  UInt halo_area = 0;
+  for (UInt rank=0; rank < graph.neighbors.size(); ++rank)
+    for (auto& [neighbor, area] : graph.neighbors[rank])
+    {
+      EXPECT_NE(neighbor, rank);
+      auto& other_neighbors = graph.neighbors[neighbor];
+      EXPECT_NE(std::find(other_neighbors.begin(), other_neighbors.end(), std::make_pair(rank, area)), other_neighbors.end());
+      halo_area += area;
+    }
+
+  // sub-blocks of a MeshBlock are always on different ranks, so the halo area is the cut surface
+  EXPECT_GT(halo_area, 0);
+  EXPECT_EQ(halo_area / 2, computeCutSurface(blocks_on_procs));
+}
@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "recursive_bisection.h"
+#include "structured_part.h"
+#include "validate.h"
+#include "utils.h"
+
+TEST(RecursiveBisection, BisectBlocks)
+{
+  auto mesh_block0 = std::make_shared<MeshBlock>(0, 10, 20, 30);
+  auto mesh_block1 = std::make_shared<MeshBlock>(1, 10, 10, 10);
+  std::vector<SplitBlock> blocks = {SplitBlock(mesh_block0), SplitBlock(mesh_block1)};
+
+  // the whole small block fits, the large one is cut along its longest direction to make up the rest
+  auto [blocks_left, blocks_right] = bisectBlocks(blocks, 4000, 0);
+  ASSERT_EQ(blocks_left.size(), 2);
+  ASSERT_EQ(blocks_right.size(), 1);
+  EXPECT_EQ(blocks_left[0].meshblock, mesh_block0);
+  EXPECT_EQ(blocks_left[0].element_counts, make_array({10, 20, 15}));
+  EXPECT_EQ(blocks_left[1].meshblock, mesh_block1);
+  EXPECT_EQ(blocks_right[0].element_counts, make_array({10, 20, 15}));
+  EXPECT_EQ(blocks_right[0].mesh_offsets, make_array({0, 0, 15}));
+
+  // no cut is needed
+  std::tie(blocks_left, blocks_right) = bisectBlocks(blocks, 1000, 0);
+  ASSERT_EQ(blocks_left.size(), 1);
+  ASSERT_EQ(blocks_right.size(), 1);
+  EXPECT_EQ(blocks_left[0].meshblock, mesh_block1);
+}
+
+TEST(RecursiveBisection, BisectBlocksZeroWeight)
+{
+  auto mesh_block0 = std::make_shared<MeshBlock>(0, 10, 20, 30, 0.0);
+  auto mesh_block1 = std::make_shared<MeshBlock>(1, 10, 10, 10);
+  std::vector<SplitBlock> blocks = {SplitBlock(mesh_block0), SplitBlock(mesh_block1)};
+
+  // only the block with weight can be cut
+  auto [blocks_left, blocks_right] = bisectBlocks(blocks, 500, 0);
+  ASSERT_EQ(blocks_left.size(), 2);
+  ASSERT_EQ(blocks_right.size(), 1);
+  EXPECT_EQ(blocks_left[0].meshblock, mesh_block0);
+  EXPECT_EQ(blocks_left[0].element_counts, make_array({10, 20, 30}));
+  EXPECT_EQ(blocks_left[1].meshblock, mesh_block1);
+  EXPECT_DOUBLE_EQ(blocks_left[1].weight, 500);
+}
+
+TEST(RecursiveBisection, PartitionMesh)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 40, 30, 20),
+                                                         std::make_shared<MeshBlock>(1, 25, 25, 25),
+                                                         std::make_shared<MeshBlock>(2, 60, 40, 1),
+                                                         std::make_shared<MeshBlock>(3, 30, 30, 10)};
+
+  PartitionOptions options;
+  options.engine = PartitionEngine::RecursiveBisection;
+  for (UInt nprocs : {1, 2, 7, 16, 33})
+  {
+    PartitionResult result = partitionMesh(mesh_blocks, nprocs, 0.05, options);
+    ASSERT_EQ(result.blocks_on_procs.size(), nprocs);
+    validateDecomposition(mesh_blocks, result.blocks_on_procs);
+    EXPECT_EQ(result.status, PartitionStatus::Balanced);
+    EXPECT_LE(result.imbalance, 0.05);
+
+    UInt num_blocks = 0;
+    for (auto& blocks : result.blocks_on_procs)
+      num_blocks += blocks.size();
+    EXPECT_LE(num_blocks, mesh_blocks.size() + nprocs - 1);
+
+    // the threads only change which thread computes each subtree
+    options.num_threads = 4;
+    EXPECT_EQ(partitionMesh(mesh_blocks, nprocs, 0.05, options).blocks_on_procs, result.blocks_on_procs);
+    options.num_threads = 1;
+  }
+
+  options.weight_mode = WeightMode::Integer;
+  EXPECT_ANY_THROW(partitionMesh(mesh_blocks, 4, 0.05, options));
+}
+
+TEST(RecursiveBisection, Unbalanced)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 1, 1, 1),
+                                                         std::make_shared<MeshBlock>(1, 1, 1, 1),
+                                                         std::make_shared<MeshBlock>(2, 1, 1, 1)};
+  PartitionOptions options;
+  options.engine = PartitionEngine::RecursiveBisection;
+  PartitionResult result = partitionMesh(mesh_blocks, 2, 0.1, options);
+
+  EXPECT_EQ(result.status, PartitionStatus::Unbalanced);
+  EXPECT_NEAR(result.imbalance, 2.0/1.5 - 1, 1e-12);
+  validateDecomposition(mesh_blocks, result.blocks_on_procs);
+}
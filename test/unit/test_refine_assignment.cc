@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include "refine_assignment.h"
+#include "adjacency.h"
+#include "final_split.h"
+#include "utils.h"
+
+TEST(Adjacency, SharedFaceArea)
+{
+  auto meshblock = std::make_shared<MeshBlock>(0, 4, 4, 4);
+  SplitBlock block1(meshblock, {2, 4, 4}, {0, 0, 0});
+  SplitBlock block2(meshblock, {2, 2, 4}, {2, 0, 0});
+  SplitBlock block3(meshblock, {2, 2, 4}, {2, 2, 0});
+
+  EXPECT_EQ(computeSharedFaceArea(block1, block2), 8);
+  EXPECT_EQ(computeSharedFaceArea(block2, block3), 8);
+  EXPECT_EQ(computeSharedFaceArea(block1, block3), 8);
+  EXPECT_EQ(computeSharedFaceArea(block1, block1), 0);
+}
+
+TEST(Adjacency, EdgeNeighborsNotAdjacent)
+{
+  auto meshblock = std::make_shared<MeshBlock>(0, 4, 4, 1);
+  SplitBlock block1(meshblock, {2, 2, 1}, {0, 0, 0});
+  SplitBlock block2(meshblock, {2, 2, 1}, {2, 2, 0});
+
+  EXPECT_FALSE(areFaceAdjacent(block1, block2));
+}
+
+TEST(Adjacency, DifferentParentsNotAdjacent)
+{
+  auto meshblock1 = std::make_shared<MeshBlock>(0, 4, 4, 1);
+  auto meshblock2 = std::make_shared<MeshBlock>(1, 4, 4, 1);
+  SplitBlock block1(meshblock1, {2, 4, 1}, {0, 0, 0});
+  SplitBlock block2(meshblock2, {2, 4, 1}, {2, 0, 0});
+
+  EXPECT_FALSE(areFaceAdjacent(block1, block2));
+  EXPECT_EQ(computeBlockAdjacency({block1, block2}).size(), 0);
+}
+
+TEST(RefineAssignment, SwapReducesNeighbors)
+{
+  auto meshblock_a = std::make_shared<MeshBlock>(0, 4, 1, 1);
+  auto meshblock_b = std::make_shared<MeshBlock>(1, 4, 1, 1);
+  std::vector<SplitBlock> a_blocks, b_blocks;
+  for (UInt i=0; i < 4; ++i)
+  {
+    a_blocks.emplace_back(meshblock_a, make_array({1, 1, 1}), make_array({i, 0, 0}));
+    b_blocks.emplace_back(meshblock_b, make_array({1, 1, 1}), make_array({i, 0, 0}));
+  }
+
+  // B1 and B2 are on the "wrong" ranks relative to A1 and A2
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = {{a_blocks[0], b_blocks[0]},
+                                                          {a_blocks[1], b_blocks[2]},
+                                                          {a_blocks[2], b_blocks[1]},
+                                                          {a_blocks[3], b_blocks[3]}};
+
+  EXPECT_EQ(computeCommStats(blocks_on_procs).num_neighbors, 5);
+
+  RefinementStats stats = refineAssignment(blocks_on_procs, 0.1);
+  EXPECT_EQ(stats.initial.num_neighbors, 5);
+  EXPECT_EQ(stats.final.num_neighbors, 3);
+  EXPECT_EQ(stats.final.halo_area, stats.initial.halo_area);
+  EXPECT_EQ(computeCommStats(blocks_on_procs).num_neighbors, 3);
+  checkDecompositionValid({meshblock_a, meshblock_b}, blocks_on_procs);
+}
+
+TEST(RefineAssignment, FinalSplitStaysBalanced)
+{
+  double load_balance_factor = 0.1;
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(1, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(2, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(3, 100, 100, 1)};
+
+  for (UInt nprocs : {7, 13, 24})
+  {
+    auto blocks_on_procs = finalSplit(mesh_blocks, nprocs, load_balance_factor);
+    for (auto objective : {CommObjective::NumNeighbors, CommObjective::MaxNeighborsPerRank})
+    {
+      auto refined_blocks_on_procs = blocks_on_procs;
+      RefinementStats stats = refineAssignment(refined_blocks_on_procs, load_balance_factor, objective);
+
+      checkDecompositionValid(mesh_blocks, refined_blocks_on_procs);
+      checkLoadBalance(refined_blocks_on_procs, load_balance_factor);
+      if (objective == CommObjective::NumNeighbors)
+        EXPECT_LE(stats.final.num_neighbors, stats.initial.num_neighbors);
+      else
+        EXPECT_LE(stats.final.max_neighbors_per_rank, stats.initial.max_neighbors_per_rank);
+    }
+  }
+}
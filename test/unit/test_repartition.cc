@@ -0,0 +1,115 @@
+#include "gtest/gtest.h"
+#include "repartition.h"
+#include "structured_part.h"
+#include "validate.h"
+#include "utils.h"
+
+namespace {
+
+std::vector<std::shared_ptr<MeshBlock>> createMeshBlocks()
+{
+  return {std::make_shared<MeshBlock>(0, 40, 30, 20),
+          std::make_shared<MeshBlock>(1, 25, 25, 25),
+          std::make_shared<MeshBlock>(2, 60, 40, 1),
+          std::make_shared<MeshBlock>(3, 30, 30, 10)};
+}
+
+}
+
+TEST(Repartition, MigrationVolume)
+{
+  auto mesh_blocks = createMeshBlocks();
+  auto blocks_on_procs = partitionMesh(mesh_blocks, 8, 0.1);
+
+  MigrationVolume migrated = computeMigrationVolume(blocks_on_procs, blocks_on_procs);
+  EXPECT_EQ(migrated.elements, 0);
+  EXPECT_EQ(migrated.weight, 0);
+
+  // moving all blocks one proc over migrates everything
+  auto rotated_blocks_on_procs = blocks_on_procs;
+  std::rotate(rotated_blocks_on_procs.begin(), rotated_blocks_on_procs.begin() + 1, rotated_blocks_on_procs.end());
+  UInt num_elements = 0;
+  for (auto& mesh_block : mesh_blocks)
+    num_elements += prod(mesh_block->element_counts);
+
+  migrated = computeMigrationVolume(blocks_on_procs, rotated_blocks_on_procs);
+  EXPECT_EQ(migrated.elements, num_elements);
+  EXPECT_NEAR(migrated.weight, num_elements, 1e-8 * num_elements);
+}
+
+TEST(Repartition, Shrink)
+{
+  auto mesh_blocks = createMeshBlocks();
+  double load_balance_factor = 0.1;
+  auto blocks_on_procs = partitionMesh(mesh_blocks, 16, load_balance_factor);
+
+  RepartitionResult result = repartitionMesh(blocks_on_procs, 15, load_balance_factor);
+  EXPECT_EQ(result.blocks_on_procs.size(), 15);
+  EXPECT_EQ(result.status, PartitionStatus::Balanced);
+  EXPECT_LE(result.imbalance, load_balance_factor);
+  validateDecomposition(mesh_blocks, result.blocks_on_procs);
+
+  // much less than partitioning from scratch, at most the orphaned proc plus the data moved to
+  // make room for it
+  double orphaned_weight = 0;
+  for (auto& block : blocks_on_procs[15])
+    orphaned_weight += block.weight;
+
+  MigrationVolume scratch = computeMigrationVolume(blocks_on_procs, partitionMesh(mesh_blocks, 15, load_balance_factor));
+  EXPECT_GE(result.migrated.weight, orphaned_weight - 1e-8);
+  EXPECT_LT(result.migrated.weight, 2 * orphaned_weight);
+  EXPECT_LT(result.migrated.weight, scratch.weight);
+}
+
+TEST(Repartition, Grow)
+{
+  auto mesh_blocks = createMeshBlocks();
+  double load_balance_factor = 0.1;
+  auto blocks_on_procs = partitionMesh(mesh_blocks, 16, load_balance_factor);
+
+  RepartitionResult result = repartitionMesh(blocks_on_procs, 18, load_balance_factor);
+  EXPECT_EQ(result.blocks_on_procs.size(), 18);
+  EXPECT_EQ(result.status, PartitionStatus::Balanced);
+  EXPECT_LE(result.imbalance, load_balance_factor);
+  validateDecomposition(mesh_blocks, result.blocks_on_procs);
+
+  MigrationVolume scratch = computeMigrationVolume(blocks_on_procs, partitionMesh(mesh_blocks, 18, load_balance_factor));
+  EXPECT_LT(result.migrated.weight, scratch.weight);
+}
+
+TEST(Repartition, ShrinkToOneProc)
+{
+  auto mesh_blocks = createMeshBlocks();
+  auto blocks_on_procs = partitionMesh(mesh_blocks, 4, 0.1);
+
+  // every proc already has a block of MeshBlock 0, so each MeshBlock is re-cut into one block
+  RepartitionResult result = repartitionMesh(blocks_on_procs, 1, 0.1);
+  EXPECT_EQ(result.blocks_on_procs.size(), 1);
+  EXPECT_EQ(result.blocks_on_procs[0].size(), mesh_blocks.size());
+  EXPECT_GT(result.num_recut_regions, 0);
+  validateDecomposition(mesh_blocks, result.blocks_on_procs);
+}
+
+TEST(Repartition, ShrinkSingleMeshBlock)
+{
+  // every proc has a sibling of every orphaned block, so the orphans can only be placed by
+  // re-cutting part of the MeshBlock
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 64, 64, 64)};
+  UInt num_elements = prod(mesh_blocks[0]->element_counts);
+  double load_balance_factor = 0.1;
+  for (UInt nprocs : {8, 16, 64})
+  {
+    auto blocks_on_procs = partitionMesh(mesh_blocks, nprocs, load_balance_factor);
+    RepartitionResult result = repartitionMesh(blocks_on_procs, nprocs - 1, load_balance_factor);
+    EXPECT_EQ(result.status, PartitionStatus::Balanced);
+    EXPECT_LE(result.imbalance, load_balance_factor);
+    EXPECT_GT(result.num_recut_regions, 0);
+    EXPECT_FALSE(result.partitioned_from_scratch);
+    validateDecomposition(mesh_blocks, result.blocks_on_procs);
+
+    // partitioning from scratch moves 70-100% of the elements
+    MigrationVolume scratch = computeMigrationVolume(blocks_on_procs, partitionMesh(mesh_blocks, nprocs - 1, load_balance_factor));
+    EXPECT_LT(result.migrated.elements, 0.4 * num_elements);
+    EXPECT_LT(result.migrated.elements, scratch.elements / 2);
+  }
+}
@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+#include "stencil_proxy.h"
+#include "structured_part.h"
+#include "utils.h"
+
+namespace {
+
+std::vector<std::shared_ptr<MeshBlock>> makeMeshBlocks()
+{
+  return {std::make_shared<MeshBlock>(0, 12, 10, 8),
+          std::make_shared<MeshBlock>(1, 7, 9, 5)};
+}
+
+double getChecksum(const std::vector<std::vector<SplitBlock>>& blocks_on_procs)
+{
+  return StencilProxy(blocks_on_procs).run(5).checksum;
+}
+
+}
+
+TEST(StencilProxy, ChecksumIndependentOfDecomposition)
+{
+  auto mesh_blocks = makeMeshBlocks();
+  std::vector<std::vector<SplitBlock>> one_rank = {{SplitBlock(mesh_blocks[0]), SplitBlock(mesh_blocks[1])}};
+  double checksum = getChecksum(one_rank);
+
+  // the boundary value has diffused into the interior, so a missing halo changes the checksum
+  EXPECT_GT(checksum, 0);
+
+  for (UInt nprocs : {2, 3, 5, 8})
+    EXPECT_NEAR(getChecksum(partitionMesh(mesh_blocks, nprocs, 0.1)), checksum, 1e-12 * checksum);
+
+  // halos between blocks on the same rank, and between blocks that share part of a face
+  std::vector<std::vector<SplitBlock>> uneven = {{SplitBlock(mesh_blocks[0], {5, 10, 8}, {0, 0, 0}),
+                                                  SplitBlock(mesh_blocks[0], {7, 4, 8}, {5, 0, 0})},
+                                                 {SplitBlock(mesh_blocks[0], {7, 6, 3}, {5, 4, 0}),
+                                                  SplitBlock(mesh_blocks[1])},
+                                                 {SplitBlock(mesh_blocks[0], {7, 6, 5}, {5, 4, 3})}};
+  EXPECT_NEAR(getChecksum(uneven), checksum, 1e-12 * checksum);
+}
+
+TEST(StencilProxy, ZeroIterations)
+{
+  auto mesh_blocks = makeMeshBlocks();
+  StencilProxy proxy(partitionMesh(mesh_blocks, 2, 0.1));
+  EXPECT_ANY_THROW(proxy.run(0));
+
+  ProxyTimings timings = proxy.run(1);
+  EXPECT_GE(timings.time_per_iteration, 0.0);
+  EXPECT_LT(timings.time_per_iteration, 10.0);
+}
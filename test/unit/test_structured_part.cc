@@ -0,0 +1,256 @@
+#include "gtest/gtest.h"
+#include "structured_part.h"
+#include "statistics.h"
+#include "adjacency.h"
+#include "utils.h"
+
+namespace {
+
+std::vector<std::shared_ptr<MeshBlock>> makeMeshBlocks()
+{
+  return {std::make_shared<MeshBlock>(0, 101, 100, 1),
+          std::make_shared<MeshBlock>(1, 100, 100, 1),
+          std::make_shared<MeshBlock>(2, 100, 100, 1),
+          std::make_shared<MeshBlock>(3, 10, 10, 1)};
+}
+
+}
+
+TEST(PartitionMesh, Sink)
+{
+  UInt nprocs = 13;
+  auto mesh_blocks = makeMeshBlocks();
+  auto blocks_on_procs = partitionMesh(mesh_blocks, nprocs, 0.1);
+
+  std::vector<std::vector<SplitBlock>> streamed_blocks_on_procs(nprocs);
+  UInt prev_rank = 0;
+  auto sink = [&](UInt rank, const SplitBlock& block)
+  {
+    EXPECT_GE(rank, prev_rank);
+    prev_rank = rank;
+    streamed_blocks_on_procs[rank].push_back(block);
+  };
+  partitionMesh(mesh_blocks, nprocs, 0.1, sink);
+
+  EXPECT_EQ(streamed_blocks_on_procs, blocks_on_procs);
+}
+
+TEST(PartitionMesh, OutputIterator)
+{
+  UInt nprocs = 13;
+  auto mesh_blocks = makeMeshBlocks();
+  auto blocks_on_procs = partitionMesh(mesh_blocks, nprocs, 0.1);
+
+  std::vector<RankBlock> rank_blocks;
+  partitionMeshTo(mesh_blocks, nprocs, 0.1, std::back_inserter(rank_blocks));
+
+  UInt idx = 0;
+  for (UInt proc=0; proc < nprocs; ++proc)
+    for (const SplitBlock& block : blocks_on_procs[proc])
+    {
+      ASSERT_LT(idx, rank_blocks.size());
+      EXPECT_EQ(rank_blocks[idx].rank, proc);
+      EXPECT_EQ(rank_blocks[idx].block, block);
+      idx++;
+    }
+  EXPECT_EQ(idx, rank_blocks.size());
+}
+
+TEST(PartitionMesh, SinkWithOptions)
+{
+  UInt nprocs = 13;
+  auto mesh_blocks = makeMeshBlocks();
+  PartitionOptions options;
+  options.engine = PartitionEngine::RecursiveBisection;
+  PartitionResult expected_result = partitionMesh(mesh_blocks, nprocs, 0.1, options);
+
+  std::vector<RankBlock> rank_blocks;
+  auto [result, out] = partitionMeshTo(mesh_blocks, nprocs, 0.1, options, std::back_inserter(rank_blocks));
+  EXPECT_EQ(result.status, expected_result.status);
+  EXPECT_EQ(result.imbalance, expected_result.imbalance);
+  EXPECT_EQ(result.blocks_on_procs.size(), 0);
+
+  std::vector<std::vector<SplitBlock>> streamed_blocks_on_procs(nprocs);
+  for (const RankBlock& rank_block : rank_blocks)
+    streamed_blocks_on_procs[rank_block.rank].push_back(rank_block.block);
+  EXPECT_EQ(streamed_blocks_on_procs, expected_result.blocks_on_procs);
+}
+
+TEST(PartitionMesh, SinkRecursiveBisection)
+{
+  UInt nprocs = 37;
+  auto mesh_blocks = makeMeshBlocks();
+  PartitionOptions options;
+  options.engine = PartitionEngine::RecursiveBisection;
+  options.num_threads = 4;
+  PartitionResult expected_result = partitionMesh(mesh_blocks, nprocs, 0.1, options);
+
+  // the ranks are passed as they are bisected, in order
+  std::vector<std::vector<SplitBlock>> streamed_blocks_on_procs(nprocs);
+  UInt prev_rank = 0;
+  auto sink = [&](UInt rank, const SplitBlock& block)
+  {
+    EXPECT_GE(rank, prev_rank);
+    prev_rank = rank;
+    streamed_blocks_on_procs[rank].push_back(block);
+  };
+  PartitionResult result = partitionMesh(mesh_blocks, nprocs, 0.1, options, sink);
+
+  EXPECT_EQ(result.status, expected_result.status);
+  EXPECT_DOUBLE_EQ(result.imbalance, expected_result.imbalance);
+  EXPECT_EQ(result.blocks_on_procs.size(), 0);
+  EXPECT_EQ(streamed_blocks_on_procs, expected_result.blocks_on_procs);
+}
+
+TEST(PartitionMesh, OptionsDefault)
+{
+  UInt nprocs = 13;
+  auto mesh_blocks = makeMeshBlocks();
+  PartitionResult result = partitionMesh(mesh_blocks, nprocs, 0.1, PartitionOptions());
+
+  EXPECT_EQ(result.status, PartitionStatus::Balanced);
+  EXPECT_LE(result.imbalance, 0.1);
+  EXPECT_GT(result.num_iterations, 0);
+  EXPECT_EQ(result.blocks_on_procs, partitionMesh(mesh_blocks, nprocs, 0.1));
+}
+
+TEST(PartitionMesh, OptionsIterationBudget)
+{
+  UInt nprocs = 13;
+  auto mesh_blocks = makeMeshBlocks();
+  PartitionOptions options;
+  options.max_iterations = 1;
+  PartitionResult result = partitionMesh(mesh_blocks, nprocs, 0.01, options);
+
+  EXPECT_EQ(result.status, PartitionStatus::BudgetExhausted);
+  EXPECT_EQ(result.num_iterations, 1);
+  EXPECT_GT(result.imbalance, 0.01);
+  checkDecompositionValid(mesh_blocks, result.blocks_on_procs);
+  checkLoadBalance(result.blocks_on_procs, result.imbalance + 1e-12);
+}
+
+TEST(PartitionMesh, OptionsNoSplittableBlock)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 1, 1, 1),
+                                                         std::make_shared<MeshBlock>(1, 1, 1, 1),
+                                                         std::make_shared<MeshBlock>(2, 1, 1, 1)};
+  EXPECT_ANY_THROW(partitionMesh(mesh_blocks, 2, 0.1));
+
+  PartitionResult result = partitionMesh(mesh_blocks, 2, 0.1, PartitionOptions());
+  EXPECT_EQ(result.status, PartitionStatus::NoSplittableBlock);
+  EXPECT_NEAR(result.imbalance, 2.0/1.5 - 1, 1e-12);
+  checkDecompositionValid(mesh_blocks, result.blocks_on_procs);
+}
+
+TEST(PartitionMesh, OptionsNoImprovement)
+{
+  auto mesh_blocks = makeMeshBlocks();
+  PartitionOptions options;
+  options.max_stalled_iterations = 1;
+
+  // the best decomposition seen is returned, not the last one
+  UInt num_stalled = 0;
+  for (UInt nprocs=2; nprocs < 40; ++nprocs)
+  {
+    PartitionResult result = partitionMesh(mesh_blocks, nprocs, 0.01, options);
+    checkDecompositionValid(mesh_blocks, result.blocks_on_procs);
+    DecompStats stats = computeDecompStats(result.blocks_on_procs);
+    EXPECT_NEAR(result.imbalance, stats.max_weight / stats.avg_weight_per_process - 1, 1e-12);
+    num_stalled += result.status == PartitionStatus::NoImprovement;
+  }
+
+  EXPECT_GT(num_stalled, 0);
+}
+
+TEST(PartitionMesh, IntegerWeights)
+{
+  auto mesh_blocks = makeMeshBlocks();
+  mesh_blocks.push_back(std::make_shared<MeshBlock>(4, 50, 30, 1, 3000.0));  // two units per element
+
+  PartitionOptions options;
+  options.weight_mode = WeightMode::Integer;
+  for (UInt nprocs : {3, 13, 40})
+  {
+    PartitionResult result = partitionMesh(mesh_blocks, nprocs, 0.1, options);
+
+    EXPECT_EQ(result.status, PartitionStatus::Balanced);
+    EXPECT_LE(result.imbalance, 0.1);
+    checkDecompositionValid(mesh_blocks, result.blocks_on_procs);
+    checkLoadBalance(result.blocks_on_procs, 0.1);
+
+    EXPECT_EQ(partitionMesh(mesh_blocks, nprocs, 0.1, options).blocks_on_procs, result.blocks_on_procs);
+  }
+}
+
+TEST(PartitionMesh, CostModel)
+{
+  UInt nprocs = 13;
+  auto mesh_blocks = makeMeshBlocks();
+
+  PartitionOptions options;
+  options.cost_model.per_block = 200;
+  options.cost_model.per_face_area = 1;
+  options.max_stalled_iterations = 50;
+  PartitionResult result = partitionMesh(mesh_blocks, nprocs, 0.1, options);
+  checkDecompositionValid(mesh_blocks, result.blocks_on_procs);
+
+  // the cost of the result is no worse than the decomposition that ignores the cost model
+  DecompStats stats = computeDecompStats(result.blocks_on_procs, options.cost_model);
+  DecompStats weight_only_stats = computeDecompStats(partitionMesh(mesh_blocks, nprocs, 0.1), options.cost_model);
+  EXPECT_LE(stats.max_cost, weight_only_stats.max_cost);
+  EXPECT_NEAR(result.imbalance, stats.max_cost / stats.avg_cost_per_process - 1, 1e-12);
+
+  options.weight_mode = WeightMode::Integer;
+  EXPECT_ANY_THROW(partitionMesh(mesh_blocks, nprocs, 0.1, options));
+}
+
+TEST(PartitionMesh, NonAdjacentSiblings)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 400, 300, 1),
+                                                         std::make_shared<MeshBlock>(1, 130, 100, 1),
+                                                         std::make_shared<MeshBlock>(2, 50, 70, 1)};
+  UInt nprocs = 29;
+  PartitionOptions options;
+  auto strict_result = partitionMesh(mesh_blocks, nprocs, 0.02, options);
+
+  options.allow_non_adjacent_siblings = true;
+  auto result = partitionMesh(mesh_blocks, nprocs, 0.02, options);
+  EXPECT_EQ(result.status, PartitionStatus::Balanced);
+  checkDecompositionValid(mesh_blocks, result.blocks_on_procs);
+  checkLoadBalance(result.blocks_on_procs, 0.02);
+
+  UInt num_blocks = 0, num_strict_blocks = 0;
+  for (UInt proc=0; proc < nprocs; ++proc)
+  {
+    num_blocks += result.blocks_on_procs[proc].size();
+    num_strict_blocks += strict_result.blocks_on_procs[proc].size();
+
+    const std::vector<SplitBlock>& blocks = result.blocks_on_procs[proc];
+    for (UInt i=0; i < blocks.size(); ++i)
+      for (UInt j=i+1; j < blocks.size(); ++j)
+        EXPECT_FALSE(areFaceAdjacent(blocks[i], blocks[j]));
+  }
+
+  EXPECT_LT(num_blocks, num_strict_blocks);
+}
+
+TEST(PartitionMesh, Batch)
+{
+  std::vector<PartitionProblem> problems;
+  for (UInt nprocs : {7, 40, 1, 23, 64, 13})
+    problems.push_back({makeMeshBlocks(), nprocs, 0.05, PartitionOptions()});
+  problems[2].options.weight_mode = WeightMode::Integer;
+
+  std::vector<PartitionResult> results = partitionMeshes(problems, 3);
+  ASSERT_EQ(results.size(), problems.size());
+  for (UInt i=0; i < problems.size(); ++i)
+  {
+    PartitionResult expected = partitionMesh(problems[i].mesh_blocks, problems[i].nprocs, problems[i].load_balance_factor, problems[i].options);
+    EXPECT_EQ(results[i].blocks_on_procs, expected.blocks_on_procs);
+    EXPECT_EQ(results[i].status, expected.status);
+  }
+
+  problems[3].nprocs = 0;
+  EXPECT_ANY_THROW(partitionMeshes(problems, 3));
+  EXPECT_EQ(partitionMeshes({}).size(), 0);
+}
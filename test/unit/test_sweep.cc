@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+#include "sweep.h"
+#include "final_split.h"
+#include "utils.h"
+
+TEST(Sweep, SameAsFinalSplit)
+{
+  double load_balance_factor = 0.1;
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 101, 100, 1),
+                                                         std::make_shared<MeshBlock>(1, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(2, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(3, 10, 10, 1)};
+  UInt nprocs_min = 3, nprocs_max = 20;
+
+  std::vector<SweepResult> sweep_results = partitionMeshSweep(mesh_blocks, nprocs_min, nprocs_max, load_balance_factor, 4);
+  ASSERT_EQ(sweep_results.size(), nprocs_max - nprocs_min + 1);
+
+  for (UInt nprocs=nprocs_min; nprocs <= nprocs_max; ++nprocs)
+  {
+    PartitionResult result = finalSplit(mesh_blocks, nprocs, load_balance_factor, PartitionOptions());
+    DecompStats stats = computeDecompStats(result.blocks_on_procs);
+    const SweepResult& sweep_result = sweep_results[nprocs - nprocs_min];
+    EXPECT_EQ(sweep_result.status, result.status);
+    EXPECT_EQ(sweep_result.imbalance, result.imbalance);
+    EXPECT_EQ(sweep_result.stats.weight_per_process, stats.weight_per_process);
+    EXPECT_EQ(sweep_result.stats.blocks_per_proc, stats.blocks_per_proc);
+    EXPECT_LE(sweep_result.stats.max_weight, sweep_result.stats.avg_weight_per_process * (1 + load_balance_factor));
+  }
+}
+
+TEST(Sweep, UnbalancedCounts)
+{
+  // 3 elements can only be balanced on 1 or 3 procs, which does not stop the sweep
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 3, 1, 1)};
+  for (PartitionEngine engine : {PartitionEngine::SplitAndAssign, PartitionEngine::RecursiveBisection})
+  {
+    PartitionOptions options;
+    options.engine = engine;
+    std::vector<SweepResult> sweep_results = partitionMeshSweep(mesh_blocks, 1, 6, 0.1, options, 2);
+    ASSERT_EQ(sweep_results.size(), 6);
+    for (UInt nprocs=1; nprocs <= 6; ++nprocs)
+    {
+      const SweepResult& sweep_result = sweep_results[nprocs - 1];
+      EXPECT_EQ(sweep_result.status == PartitionStatus::Balanced, nprocs == 1 || nprocs == 3);
+      EXPECT_EQ(sweep_result.stats.weight_per_process.size(), nprocs);
+      EXPECT_NEAR(sweep_result.imbalance, sweep_result.stats.max_weight / sweep_result.stats.avg_weight_per_process - 1, 1e-12);
+    }
+  }
+}
+
+TEST(Sweep, InvalidRange)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 10, 10, 1)};
+  EXPECT_ANY_THROW(partitionMeshSweep(mesh_blocks, 0, 10, 0.1));
+  EXPECT_ANY_THROW(partitionMeshSweep(mesh_blocks, 5, 4, 0.1));
+}
+
+TEST(Sweep, CachedFinalSplitWithOptions)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 101, 100, 1),
+                                                         std::make_shared<MeshBlock>(1, 37, 80, 1)};
+  SplitCache cache;
+  for (RemainderStrategy remainder_strategy : {RemainderStrategy::NestedSlabs, RemainderStrategy::SpreadOverRows})
+    for (WeightMode weight_mode : {WeightMode::Floating, WeightMode::Integer})
+      for (UInt nprocs : {7, 13})
+      {
+        PartitionOptions options;
+        options.remainder_strategy = remainder_strategy;
+        options.weight_mode = weight_mode;
+        EXPECT_EQ(finalSplit(mesh_blocks, nprocs, 0.1, options, cache).blocks_on_procs,
+                  finalSplit(mesh_blocks, nprocs, 0.1, options).blocks_on_procs);
+      }
+}
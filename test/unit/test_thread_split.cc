@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+#include "thread_split.h"
+#include "final_split.h"
+#include "utils.h"
+
+namespace {
+
+void checkTilesCoverBlocks(const std::vector<SplitBlock>& blocks_on_proc, const std::vector<std::vector<SplitBlock>>& tiles_on_threads)
+{
+  double block_weight = 0.0, tile_weight = 0.0;
+  UInt block_elements = 0, tile_elements = 0;
+  for (const SplitBlock& block : blocks_on_proc)
+  {
+    block_weight += block.weight;
+    block_elements += prod(block.element_counts);
+  }
+
+  for (const auto& tiles : tiles_on_threads)
+    for (const SplitBlock& tile : tiles)
+    {
+      tile_weight += tile.weight;
+      tile_elements += prod(tile.element_counts);
+
+      bool found_parent = false;
+      for (const SplitBlock& block : blocks_on_proc)
+      {
+        bool inside = tile.meshblock == block.meshblock;
+        for (UInt d=0; d < 3; ++d)
+          inside = inside && tile.mesh_offsets[d] >= block.mesh_offsets[d] &&
+                   tile.mesh_offsets[d] + tile.element_counts[d] <= block.mesh_offsets[d] + block.element_counts[d];
+        found_parent = found_parent || inside;
+      }
+      EXPECT_TRUE(found_parent);
+    }
+
+  EXPECT_EQ(tile_elements, block_elements);
+  EXPECT_NEAR(tile_weight, block_weight, 1e-8*block_weight);
+}
+
+// checks that the threads, in order, have consecutive runs of the elements of the blocks in memory order
+void checkTilesContiguous(const std::vector<SplitBlock>& blocks_on_proc, const std::vector<std::vector<SplitBlock>>& tiles_on_threads)
+{
+  UInt block_idx = 0, position = 0;
+  for (const auto& tiles : tiles_on_threads)
+    for (const SplitBlock& tile : tiles)
+    {
+      if (position == prod(blocks_on_proc[block_idx].element_counts))
+      {
+        block_idx++;
+        position = 0;
+      }
+
+      const SplitBlock& block = blocks_on_proc[block_idx];
+      const auto& counts = block.element_counts;
+      EXPECT_EQ(tile.meshblock, block.meshblock);
+      UInt i = tile.mesh_offsets[0] - block.mesh_offsets[0], j = tile.mesh_offsets[1] - block.mesh_offsets[1],
+           k = tile.mesh_offsets[2] - block.mesh_offsets[2];
+      EXPECT_EQ((i * counts[1] + j) * counts[2] + k, position);
+
+      if (tile.element_counts[0] > 1 || tile.element_counts[1] > 1)
+        EXPECT_EQ(tile.element_counts[2], counts[2]);
+      if (tile.element_counts[0] > 1)
+        EXPECT_EQ(tile.element_counts[1], counts[1]);
+
+      position += prod(tile.element_counts);
+    }
+
+  EXPECT_EQ(block_idx, blocks_on_proc.size() - 1);
+  EXPECT_EQ(position, prod(blocks_on_proc.back().element_counts));
+}
+
+double computeImbalance(const std::vector<std::vector<SplitBlock>>& tiles_on_threads)
+{
+  double total_weight = 0.0, max_weight = 0.0;
+  for (const auto& tiles : tiles_on_threads)
+  {
+    double weight = 0.0;
+    for (const SplitBlock& tile : tiles)
+      weight += tile.weight;
+
+    total_weight += weight;
+    max_weight = std::max(max_weight, weight);
+  }
+
+  return max_weight / (total_weight / tiles_on_threads.size()) - 1;
+}
+
+}
+
+TEST(ThreadSplit, SingleBlock)
+{
+  auto mesh_block = std::make_shared<MeshBlock>(0, 100, 100, 1);
+  std::vector<SplitBlock> blocks_on_proc = {SplitBlock(mesh_block)};
+
+  for (UInt nthreads=1; nthreads < 20; ++nthreads)
+  {
+    ThreadTiles result = splitIntoThreadTiles(blocks_on_proc, nthreads, 0.1);
+    EXPECT_EQ(result.tiles_on_threads.size(), nthreads);
+    EXPECT_EQ(result.status, PartitionStatus::Balanced);
+    EXPECT_NEAR(result.imbalance, computeImbalance(result.tiles_on_threads), 1e-12);
+    checkTilesCoverBlocks(blocks_on_proc, result.tiles_on_threads);
+    checkTilesContiguous(blocks_on_proc, result.tiles_on_threads);
+    checkLoadBalance(result.tiles_on_threads, 0.1);
+  }
+}
+
+TEST(ThreadSplit, ThinBlocks)
+{
+  // rows and single elements are needed to balance these
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 1, 7, 130),
+                                                         std::make_shared<MeshBlock>(1, 1, 1, 50, 30.0),
+                                                         std::make_shared<MeshBlock>(2, 3, 5, 7)};
+  std::vector<SplitBlock> blocks_on_proc;
+  for (const auto& mesh_block : mesh_blocks)
+    blocks_on_proc.emplace_back(mesh_block);
+
+  for (UInt nthreads=1; nthreads < 20; ++nthreads)
+  {
+    ThreadTiles result = splitIntoThreadTiles(blocks_on_proc, nthreads, 0.05);
+    EXPECT_EQ(result.status, PartitionStatus::Balanced);
+    checkTilesCoverBlocks(blocks_on_proc, result.tiles_on_threads);
+    checkTilesContiguous(blocks_on_proc, result.tiles_on_threads);
+    checkLoadBalance(result.tiles_on_threads, 0.05);
+  }
+}
+
+TEST(ThreadSplit, Unbalanced)
+{
+  auto mesh_block = std::make_shared<MeshBlock>(0, 1, 1, 3);
+  std::vector<SplitBlock> blocks_on_proc = {SplitBlock(mesh_block)};
+  ThreadTiles result = splitIntoThreadTiles(blocks_on_proc, 2, 0.1);
+
+  EXPECT_EQ(result.status, PartitionStatus::NoSplittableBlock);
+  EXPECT_NEAR(result.imbalance, 1.0/3.0, 1e-12);
+  checkTilesCoverBlocks(blocks_on_proc, result.tiles_on_threads);
+  checkTilesContiguous(blocks_on_proc, result.tiles_on_threads);
+}
+
+TEST(ThreadSplit, TilesInMemoryOrder)
+{
+  auto mesh_block = std::make_shared<MeshBlock>(0, 100, 100, 1);
+  std::vector<SplitBlock> blocks_on_proc = {SplitBlock(mesh_block)};
+  auto tiles_on_threads = splitIntoThreadTiles(blocks_on_proc, 4, 0.1).tiles_on_threads;
+
+  // whole planes are within the load balance factor
+  for (UInt thread=0; thread < tiles_on_threads.size(); ++thread)
+  {
+    EXPECT_EQ(tiles_on_threads[thread].size(), 1u);
+    EXPECT_EQ(tiles_on_threads[thread][0].mesh_offsets, (std::array<UInt, 3>{25*thread, 0, 0}));
+  }
+}
+
+TEST(ThreadSplit, AllRanks)
+{
+  double load_balance_factor = 0.1;
+  UInt nprocs = 7, nthreads = 6;
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 101, 100, 1),
+                                                         std::make_shared<MeshBlock>(1, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(2, 100, 100, 1),
+                                                         std::make_shared<MeshBlock>(3, 10, 10, 1)};
+  auto blocks_on_procs = finalSplit(mesh_blocks, nprocs, load_balance_factor);
+  auto tiles_on_procs = splitIntoThreadTiles(blocks_on_procs, nthreads, load_balance_factor);
+
+  EXPECT_EQ(tiles_on_procs.size(), nprocs);
+  for (UInt proc=0; proc < nprocs; ++proc)
+  {
+    const auto& tiles_on_threads = tiles_on_procs[proc].tiles_on_threads;
+    EXPECT_EQ(tiles_on_threads.size(), nthreads);
+    EXPECT_EQ(tiles_on_procs[proc].status, PartitionStatus::Balanced);
+    checkTilesCoverBlocks(blocks_on_procs[proc], tiles_on_threads);
+    checkTilesContiguous(blocks_on_procs[proc], tiles_on_threads);
+    checkLoadBalance(tiles_on_threads, load_balance_factor);
+  }
+}
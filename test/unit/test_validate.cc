@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "validate.h"
+#include "final_split.h"
+#include "utils.h"
+
+namespace {
+
+std::vector<std::shared_ptr<MeshBlock>> makeMeshBlocks()
+{
+  return {std::make_shared<MeshBlock>(0, 4, 4, 1),
+          std::make_shared<MeshBlock>(1, 3, 5, 2)};
+}
+
+}
+
+TEST(Validate, FinalSplit)
+{
+  std::vector<std::shared_ptr<MeshBlock>> mesh_blocks = {std::make_shared<MeshBlock>(0, 101, 100, 1),
+                                                         std::make_shared<MeshBlock>(1, 100, 70, 9),
+                                                         std::make_shared<MeshBlock>(2, 10, 10, 1)};
+  for (UInt nprocs : {1, 2, 7, 13, 37})
+    EXPECT_NO_THROW(validateDecomposition(mesh_blocks, finalSplit(mesh_blocks, nprocs, 0.1)));
+}
+
+TEST(Validate, Valid)
+{
+  auto mesh_blocks = makeMeshBlocks();
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = {{SplitBlock(mesh_blocks[0], {4, 2, 1}, {0, 0, 0}), SplitBlock(mesh_blocks[1])},
+                                                          {SplitBlock(mesh_blocks[0], {4, 2, 1}, {0, 2, 0})}};
+  EXPECT_NO_THROW(validateDecomposition(mesh_blocks, blocks_on_procs));
+}
+
+TEST(Validate, Gap)
+{
+  auto mesh_blocks = makeMeshBlocks();
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = {{SplitBlock(mesh_blocks[0], {4, 2, 1}, {0, 0, 0}), SplitBlock(mesh_blocks[1])},
+                                                          {SplitBlock(mesh_blocks[0], {3, 2, 1}, {0, 2, 0})}};
+  EXPECT_THROW(validateDecomposition(mesh_blocks, blocks_on_procs), std::runtime_error);
+}
+
+TEST(Validate, OverlapWithCorrectVolume)
+{
+  // the blocks have the right total volume, but overlap and leave a gap
+  auto mesh_blocks = makeMeshBlocks();
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = {{SplitBlock(mesh_blocks[0], {4, 2, 1}, {0, 0, 0}), SplitBlock(mesh_blocks[1])},
+                                                          {SplitBlock(mesh_blocks[0], {4, 2, 1}, {0, 1, 0})}};
+  EXPECT_THROW(validateDecomposition(mesh_blocks, blocks_on_procs), std::runtime_error);
+}
+
+TEST(Validate, OutOfBounds)
+{
+  auto mesh_blocks = makeMeshBlocks();
+  auto split_block = SplitBlock(mesh_blocks[0]);
+  split_block.mesh_offsets[0] = 1;
+  EXPECT_THROW(validateDecomposition(mesh_blocks, {{split_block, SplitBlock(mesh_blocks[1])}}), std::runtime_error);
+}
+
+TEST(Validate, UnknownMeshBlock)
+{
+  auto mesh_blocks = makeMeshBlocks();
+  auto other_mesh_block = std::make_shared<MeshBlock>(0, 4, 4, 1);
+  EXPECT_THROW(validateDecomposition(mesh_blocks, {{SplitBlock(other_mesh_block), SplitBlock(mesh_blocks[1])}}), std::runtime_error);
+}
+
+TEST(Validate, Siblings)
+{
+  auto mesh_blocks = makeMeshBlocks();
+  std::vector<std::vector<SplitBlock>> adjacent_blocks_on_procs = {{SplitBlock(mesh_blocks[0], {4, 2, 1}, {0, 0, 0}),
+                                                                    SplitBlock(mesh_blocks[0], {4, 2, 1}, {0, 2, 0}),
+                                                                    SplitBlock(mesh_blocks[1])}};
+  EXPECT_THROW(validateDecomposition(mesh_blocks, adjacent_blocks_on_procs), std::runtime_error);
+  EXPECT_THROW(validateDecomposition(mesh_blocks, adjacent_blocks_on_procs, true), std::runtime_error);
+
+  std::vector<std::vector<SplitBlock>> blocks_on_procs = {{SplitBlock(mesh_blocks[0], {4, 1, 1}, {0, 0, 0}),
+                                                           SplitBlock(mesh_blocks[0], {4, 2, 1}, {0, 2, 0}),
+                                                           SplitBlock(mesh_blocks[1])},
+                                                          {SplitBlock(mesh_blocks[0], {4, 1, 1}, {0, 1, 0})}};
+  EXPECT_THROW(validateDecomposition(mesh_blocks, blocks_on_procs), std::runtime_error);
+  EXPECT_NO_THROW(validateDecomposition(mesh_blocks, blocks_on_procs, true));
+}